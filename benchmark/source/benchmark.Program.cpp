@@ -0,0 +1,781 @@
+/**
+ * Microbenchmarks of the system layer primitives.
+ *
+ * The program replaces a user application, executes the benchmarks and
+ * prints one JSON object per line for each measurement, so the results
+ * can be compared between releases by a script.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "Program.hpp"
+#include "system.System.hpp"
+#include "system.Allocator.hpp"
+#include "system.Mutex.hpp"
+#include "system.Semaphore.hpp"
+#include "system.Barrier.hpp"
+#include "system.Interrupt.hpp"
+#include "system.Clock.hpp"
+#include "system.Syscall.hpp"
+#include "system.ThreadPool.hpp"
+#include <stdio.h>
+
+namespace local
+{
+    namespace benchmark
+    {
+        /**
+         * The number of iterations of fast operations.
+         */
+        const int32 ITERATIONS = 100000;
+
+        /**
+         * The number of iterations of operations which switch threads.
+         */
+        const int32 SWITCHES = 10000;
+
+        /**
+         * The stack size of benchmark threads.
+         */
+        const int32 STACK_SIZE = 0x1000;
+
+        /**
+         * The interrupt source of interrupt benchmarks.
+         */
+        const int32 SOURCE = 0;
+
+        /**
+         * Returns the current time.
+         *
+         * @return time in nanoseconds.
+         */
+        int64 getTime()
+        {
+            return system::Clock::getTime();
+        }
+
+        /**
+         * Prints a measurement.
+         *
+         * @param name       a benchmark name.
+         * @param param      a benchmark parameter.
+         * @param operations the number of measured operations.
+         * @param time       the time of the operations in nanoseconds.
+         */
+        void report(const char* name, int32 param, int32 operations, int64 time)
+        {
+            double const nanos = static_cast<double>(time) / static_cast<double>(operations);
+            ::printf("{\"benchmark\":\"%s\",\"param\":%d,\"operations\":%d,\"time_ns\":%lld,\"ns_per_op\":%.1f}\n",
+                name, static_cast<int>(param), static_cast<int>(operations), static_cast<long long>(time), nanos);
+            ::fflush(stdout);
+        }
+
+        /**
+         * A base task of the benchmarks.
+         */
+        class Task : public system::Object, public api::Task
+        {
+            typedef system::Object Parent;
+
+        public:
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const
+            {
+                return Parent::isConstructed();
+            }
+
+            /**
+             * Returns size of stack.
+             *
+             * @return stack size in bytes.
+             */
+            virtual int32 getStackSize() const
+            {
+                return STACK_SIZE;
+            }
+        };
+
+        /**
+         * The task does nothing.
+         */
+        class Empty : public Task
+        {
+
+        public:
+
+            /**
+             * Starts the task.
+             *
+             * @return zero.
+             */
+            virtual int32 start()
+            {
+                return 0;
+            }
+        };
+
+        /**
+         * The task locks a mutex, and works holding it.
+         */
+        class Locker : public Task
+        {
+
+        public:
+
+            /**
+             * The number of counter increments holding the mutex.
+             */
+            static const int32 WORK = 64;
+
+            /**
+             * Constructor.
+             *
+             * @param mutex   a mutex.
+             * @param barrier a barrier of all lockers, which starts them together.
+             * @param counter a counter shared by all lockers.
+             */
+            Locker(system::Mutex& mutex, system::Barrier& barrier, volatile int32& counter) :
+                mutex_   (mutex),
+                barrier_ (barrier),
+                counter_ (counter),
+                begin_   (0),
+                end_     (0){
+            }
+
+            /**
+             * Starts the task.
+             *
+             * @return zero.
+             */
+            virtual int32 start()
+            {
+                barrier_.await();
+                begin_ = getTime();
+                for(int32 i=0; i<SWITCHES; i++)
+                {
+                    mutex_.lock();
+                    for(int32 j=0; j<WORK; j++)
+                    {
+                        counter_++;
+                    }
+                    mutex_.unlock();
+                }
+                end_ = getTime();
+                return 0;
+            }
+
+            /**
+             * Returns the time the locking has begun at.
+             *
+             * @return time in nanoseconds.
+             */
+            int64 getBegin() const
+            {
+                return begin_;
+            }
+
+            /**
+             * Returns the time the locking has ended at.
+             *
+             * @return time in nanoseconds.
+             */
+            int64 getEnd() const
+            {
+                return end_;
+            }
+
+        private:
+
+            /**
+             * The mutex.
+             */
+            system::Mutex& mutex_;
+
+            /**
+             * The barrier of all lockers.
+             */
+            system::Barrier& barrier_;
+
+            /**
+             * The counter shared by all lockers.
+             */
+            volatile int32& counter_;
+
+            /**
+             * The time the locking has begun at.
+             */
+            int64 begin_;
+
+            /**
+             * The time the locking has ended at.
+             */
+            int64 end_;
+        };
+
+        /**
+         * The task answers pings of a semaphore by another semaphore.
+         */
+        class Ponger : public Task
+        {
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param ping a semaphore of pings.
+             * @param pong a semaphore of answers.
+             */
+            Ponger(system::Semaphore& ping, system::Semaphore& pong) :
+                ping_ (ping),
+                pong_ (pong){
+            }
+
+            /**
+             * Starts the task.
+             *
+             * @return zero.
+             */
+            virtual int32 start()
+            {
+                for(int32 i=0; i<SWITCHES; i++)
+                {
+                    ping_.acquire();
+                    pong_.release();
+                }
+                return 0;
+            }
+
+        private:
+
+            /**
+             * The semaphore of pings.
+             */
+            system::Semaphore& ping_;
+
+            /**
+             * The semaphore of answers.
+             */
+            system::Semaphore& pong_;
+        };
+
+        /**
+         * The task waits on a semaphore for keeping its thread registered.
+         */
+        class Sleeper : public Task
+        {
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param sem a semaphore.
+             */
+            Sleeper(system::Semaphore& sem) :
+                sem_ (sem){
+            }
+
+            /**
+             * Starts the task.
+             *
+             * @return zero.
+             */
+            virtual int32 start()
+            {
+                sem_.acquire();
+                return 0;
+            }
+
+        private:
+
+            /**
+             * The semaphore.
+             */
+            system::Semaphore& sem_;
+        };
+
+        /**
+         * The task measures getting the current thread.
+         */
+        class Finder : public Task
+        {
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param threads the number of other registered threads.
+             */
+            Finder(int32 threads) :
+                threads_ (threads){
+            }
+
+            /**
+             * Starts the task.
+             *
+             * @return zero.
+             */
+            virtual int32 start()
+            {
+                api::Scheduler& scheduler = system::System::call().getScheduler();
+                int64 const time = getTime();
+                for(int32 i=0; i<ITERATIONS; i++)
+                {
+                    scheduler.getCurrentThread();
+                }
+                report("Scheduler.getCurrentThread", threads_, ITERATIONS, getTime() - time);
+                return 0;
+            }
+
+        private:
+
+            /**
+             * The number of other registered threads.
+             */
+            int32 threads_;
+        };
+
+        /**
+         * The task measures the system calls selected by a system class.
+         *
+         * @param T a system class.
+         */
+        template <class T>
+        class Caller : public Task
+        {
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param name a name of the system calls.
+             */
+            Caller(const char* name) :
+                name_ (name){
+            }
+
+            /**
+             * Starts the task.
+             *
+             * @return zero.
+             */
+            virtual int32 start()
+            {
+                static char buffer[64];
+                int64 time = getTime();
+                for(int32 i=0; i<ITERATIONS; i++)
+                {
+                    system::Syscall<T>::free( system::Syscall<T>::allocate(64) );
+                }
+                ::sprintf(buffer, "%s.allocate+free", name_);
+                report(buffer, 64, ITERATIONS, getTime() - time);
+                time = getTime();
+                for(int32 i=0; i<ITERATIONS; i++)
+                {
+                    system::Syscall<T>::getTime();
+                }
+                ::sprintf(buffer, "%s.getTime", name_);
+                report(buffer, 0, ITERATIONS, getTime() - time);
+                // The thread of the task is registered, so it is found
+                time = getTime();
+                for(int32 i=0; i<ITERATIONS; i++)
+                {
+                    system::Syscall<T>::getCurrentThread();
+                }
+                ::sprintf(buffer, "%s.getCurrentThread", name_);
+                report(buffer, 0, ITERATIONS, getTime() - time);
+                return 0;
+            }
+
+        private:
+
+            /**
+             * The name of the system calls.
+             */
+            const char* name_;
+        };
+
+        /**
+         * The function object sums words of a buffer.
+         */
+        class Checksum
+        {
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param buffer a buffer.
+             */
+            Checksum(const uint32* buffer) :
+                buffer_ (buffer){
+            }
+
+            /**
+             * Sums words of a chunk.
+             *
+             * @param begin the first word index.
+             * @param end   the index next to the last word index.
+             * @param sum   the sum the words are added to.
+             */
+            void operator()(int32 const begin, int32 const end, uint32& sum) const
+            {
+                for(int32 i=begin; i<end; i++)
+                {
+                    sum += buffer_[i];
+                }
+            }
+
+            /**
+             * Combines two sums.
+             *
+             * @param sum1 a sum.
+             * @param sum2 a sum.
+             * @return the sum of the sums.
+             */
+            uint32 operator()(uint32 const& sum1, uint32 const& sum2) const
+            {
+                return sum1 + sum2;
+            }
+
+        private:
+
+            /**
+             * The buffer.
+             */
+            const uint32* buffer_;
+        };
+
+        /**
+         * Executes a task in a new thread and waits for its completion.
+         *
+         * @param task a task.
+         * @return true if the task has been executed.
+         */
+        bool execute(api::Task& task)
+        {
+            api::Thread* const thread = system::System::call().getScheduler().createThread(task);
+            if(thread == NULL) return false;
+            thread->execute();
+            thread->join();
+            delete thread;
+            return true;
+        }
+
+        /**
+         * Measures getting the time.
+         */
+        void measureClock()
+        {
+            api::System& system = system::System::call();
+            int64 time = getTime();
+            for(int32 i=0; i<ITERATIONS; i++)
+            {
+                system.getTime();
+            }
+            report("System.getTime", 0, ITERATIONS, getTime() - time);
+            time = getTime();
+            for(int32 i=0; i<ITERATIONS; i++)
+            {
+                system::Clock::getTime();
+            }
+            report("Clock.getTime", 0, ITERATIONS, getTime() - time);
+            time = getTime();
+            for(int32 i=0; i<ITERATIONS; i++)
+            {
+                system::Clock::getCounter();
+            }
+            report("Clock.getCounter", 0, ITERATIONS, getTime() - time);
+        }
+
+        /**
+         * Measures the virtual and the static system calls.
+         */
+        void measureSyscall()
+        {
+            Caller<api::System> virtualCaller("Syscall.virtual");
+            execute(virtualCaller);
+            Caller<system::System> staticCaller("Syscall.static");
+            execute(staticCaller);
+        }
+
+        /**
+         * Measures allocating and freeing memory.
+         */
+        void measureAllocator()
+        {
+            static const int32 sizes[] = {8, 64, 512, 4096};
+            static void* blocks[1024];
+            for(uint32 s=0; s<sizeof(sizes)/sizeof(sizes[0]); s++)
+            {
+                size_t const size = static_cast<size_t>(sizes[s]);
+                int64 time = getTime();
+                for(int32 i=0; i<ITERATIONS; i++)
+                {
+                    system::Allocator::free( system::Allocator::allocate(size) );
+                }
+                report("Allocator.allocate+free", sizes[s], ITERATIONS, getTime() - time);
+                int32 const number = sizeof(blocks) / sizeof(blocks[0]);
+                int64 allocation = 0;
+                int64 freeing = 0;
+                for(int32 i=0; i<ITERATIONS / number; i++)
+                {
+                    time = getTime();
+                    for(int32 j=0; j<number; j++)
+                    {
+                        blocks[j] = system::Allocator::allocate(size);
+                    }
+                    allocation += getTime() - time;
+                    time = getTime();
+                    for(int32 j=0; j<number; j++)
+                    {
+                        system::Allocator::free(blocks[j]);
+                    }
+                    freeing += getTime() - time;
+                }
+                report("Allocator.allocate", sizes[s], ITERATIONS / number * number, allocation);
+                report("Allocator.free", sizes[s], ITERATIONS / number * number, freeing);
+            }
+            // A buffer grows by small steps as a log buffer does
+            int32 const step = 64;
+            int32 const steps = 1024;
+            int64 const time = getTime();
+            for(int32 i=0; i<ITERATIONS / steps; i++)
+            {
+                void* buffer = NULL;
+                for(int32 j=1; j<=steps; j++)
+                {
+                    buffer = system::Allocator::reallocate( buffer, static_cast<size_t>(j * step) );
+                }
+                system::Allocator::free(buffer);
+            }
+            report("Allocator.reallocate", step, ITERATIONS / steps * steps, getTime() - time);
+        }
+
+        /**
+         * Measures locking and unlocking a mutex.
+         */
+        void measureMutex()
+        {
+            system::Mutex mutex;
+            int64 time = getTime();
+            for(int32 i=0; i<ITERATIONS; i++)
+            {
+                mutex.lock();
+                mutex.unlock();
+            }
+            report("Mutex.lock+unlock", 1, ITERATIONS, getTime() - time);
+            volatile int32 counter = 0;
+            time = getTime();
+            for(int32 i=0; i<SWITCHES * 2; i++)
+            {
+                mutex.lock();
+                for(int32 j=0; j<Locker::WORK; j++)
+                {
+                    counter++;
+                }
+                mutex.unlock();
+            }
+            report("Mutex.lock+work+unlock", 1, SWITCHES * 2, getTime() - time);
+            // Two threads, which are started together, contend for the mutex held during some work
+            system::Barrier barrier(2);
+            Locker firstLocker(mutex, barrier, counter);
+            Locker secondLocker(mutex, barrier, counter);
+            api::Scheduler& scheduler = system::System::call().getScheduler();
+            api::Thread* const first = scheduler.createThread(firstLocker);
+            api::Thread* const second = scheduler.createThread(secondLocker);
+            if(first == NULL || second == NULL)
+            {
+                delete first;
+                delete second;
+                return;
+            }
+            first->execute();
+            second->execute();
+            first->join();
+            second->join();
+            // Only the locking loops are measured, without creating and starting the threads
+            int64 const begin = firstLocker.getBegin() < secondLocker.getBegin() ? firstLocker.getBegin() : secondLocker.getBegin();
+            int64 const end = firstLocker.getEnd() > secondLocker.getEnd() ? firstLocker.getEnd() : secondLocker.getEnd();
+            report("Mutex.lock+work+unlock", 2, SWITCHES * 2, end - begin);
+            delete first;
+            delete second;
+        }
+
+        /**
+         * Measures ping-pong of two threads on semaphores.
+         */
+        void measureSemaphore()
+        {
+            system::Semaphore ping(0);
+            system::Semaphore pong(0);
+            Ponger forward(ping, pong);
+            Ponger backward(pong, ping);
+            api::Scheduler& scheduler = system::System::call().getScheduler();
+            api::Thread* const first = scheduler.createThread(forward);
+            api::Thread* const second = scheduler.createThread(backward);
+            if(first == NULL || second == NULL)
+            {
+                delete first;
+                delete second;
+                return;
+            }
+            first->execute();
+            second->execute();
+            // One permit passes through both threads on each round trip
+            int64 const time = getTime();
+            ping.release();
+            first->join();
+            second->join();
+            report("Semaphore.pingpong", 2, SWITCHES, getTime() - time);
+            delete first;
+            delete second;
+        }
+
+        /**
+         * Measures creating and joining threads.
+         */
+        void measureThread()
+        {
+            Empty empty;
+            int32 const number = SWITCHES / 10;
+            int64 const time = getTime();
+            for(int32 i=0; i<number; i++)
+            {
+                if( not execute(empty) ) return;
+            }
+            report("Scheduler.createThread+join", 1, number, getTime() - time);
+        }
+
+        /**
+         * Measures getting the current thread with other registered threads.
+         */
+        void measureCurrentThread()
+        {
+            static const int32 numbers[] = {0, 16, 128};
+            static api::Thread* threads[128];
+            api::Scheduler& scheduler = system::System::call().getScheduler();
+            for(uint32 n=0; n<sizeof(numbers)/sizeof(numbers[0]); n++)
+            {
+                system::Semaphore sem(0);
+                Sleeper sleeper(sem);
+                int32 number = 0;
+                for(; number<numbers[n]; number++)
+                {
+                    threads[number] = scheduler.createThread(sleeper);
+                    if(threads[number] == NULL) break;
+                    threads[number]->execute();
+                }
+                // The finder thread is registered after the other threads
+                Finder finder(number);
+                execute(finder);
+                sem.release(number);
+                for(int32 i=0; i<number; i++)
+                {
+                    threads[i]->join();
+                    delete threads[i];
+                }
+            }
+        }
+
+        /**
+         * Measures jumps to interrupt vectors.
+         */
+        void measureInterrupt()
+        {
+            Empty handler;
+            system::Interrupt direct(handler, SOURCE);
+            if( not direct.isConstructed() ) return;
+            direct.enable(true);
+            int64 time = getTime();
+            for(int32 i=0; i<SWITCHES; i++)
+            {
+                direct.jump();
+            }
+            report("Interrupt.jump", 0, SWITCHES, getTime() - time);
+            time = getTime();
+            for(int32 i=0; i<SWITCHES; i++)
+            {
+                direct.jump(false);
+            }
+            report("Interrupt.jump.async", 0, SWITCHES, getTime() - time);
+        }
+
+        /**
+         * Measures jumps to deferred interrupt vectors.
+         */
+        void measureDeferredInterrupt()
+        {
+            Empty handler;
+            system::System& system = static_cast<system::System&>( system::System::call() );
+            api::Interrupt* const deferred = system.createDeferredInterrupt(handler, SOURCE);
+            if(deferred == NULL) return;
+            deferred->enable(true);
+            int64 const time = getTime();
+            for(int32 i=0; i<SWITCHES; i++)
+            {
+                deferred->jump();
+            }
+            report("Interrupt.jump.deferred", 0, SWITCHES, getTime() - time);
+            delete deferred;
+        }
+
+        /**
+         * Measures a parallel checksum with different numbers of pool threads.
+         */
+        void measureThreadPool()
+        {
+            static const int32 workers[] = {0, 1, 3, 7};
+            static uint32 buffer[0x40000];
+            int32 const length = sizeof(buffer) / sizeof(buffer[0]);
+            int32 const rounds = 16;
+            for(int32 i=0; i<length; i++)
+            {
+                buffer[i] = static_cast<uint32>(i);
+            }
+            Checksum const checksum(buffer);
+            for(uint32 w=0; w<sizeof(workers)/sizeof(workers[0]); w++)
+            {
+                system::ThreadPool pool(system::System::call().getScheduler(), workers[w]);
+                if( not pool.isConstructed() ) return;
+                uint32 sum;
+                int64 const time = getTime();
+                for(int32 i=0; i<rounds; i++)
+                {
+                    pool.parallelReduce(0, length, 0u, checksum, checksum, sum);
+                }
+                report("ThreadPool.parallelReduce", pool.getThreadsNumber(), rounds * length, getTime() - time);
+            }
+        }
+    }
+
+    /**
+     * Executes the benchmarks.
+     *
+     * @return zero.
+     */
+    int32 Program::start()
+    {
+        benchmark::measureClock();
+        benchmark::measureSyscall();
+        benchmark::measureAllocator();
+        benchmark::measureMutex();
+        benchmark::measureSemaphore();
+        benchmark::measureThread();
+        benchmark::measureCurrentThread();
+        benchmark::measureInterrupt();
+        benchmark::measureDeferredInterrupt();
+        benchmark::measureThreadPool();
+        return 0;
+    }
+}
@@ -0,0 +1,33 @@
+/**
+ * Host port of the operating system module interface.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef MAPI_H_
+#define MAPI_H_
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Loads a module after the current one.
+ *
+ * The host port loads a shared object of the path into the process.
+ *
+ * @param res  the loader service resource.
+ * @param path a module path.
+ * @param args a module arguments, or NULL.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t mapi_loadafterme(uint32_t res, const char* path, void* args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MAPI_H_
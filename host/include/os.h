@@ -0,0 +1,359 @@
+/**
+ * Host port of the operating system interface.
+ *
+ * The interface implements the subset of the Amoeba kernel interface
+ * used by the system layer on top of POSIX threads and signals, so the layer
+ * can be built and executed as a Linux process.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef OS_H_
+#define OS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Invalid resource.
+ */
+#define RES_VOID        (0xFFFFFFFFu)
+
+/**
+ * Operating system error codes.
+ */
+#define OSE_OK          (0)
+#define OSE_ERROR       (-1)
+
+/**
+ * Semaphore error codes and states.
+ */
+#define SEM_OK          (0)
+#define SEM_ERROR       (-1)
+#define SEM_TIMEOUT     (1)
+#define SEM_UNLOCKED    (0)
+#define SEM_LOCKED      (1)
+
+/**
+ * Infinite semaphore timeout.
+ */
+#define SEM_INFINITY    (0xFFFFFFFFu)
+
+/**
+ * Heap memory alignments.
+ */
+#define HEAP_ALIGN_4    (4)
+#define HEAP_ALIGN_8    (8)
+
+/**
+ * The number of interrupt sources.
+ *
+ * A source N is also raised by the SIGRTMIN + N signal sent to the process.
+ */
+#define INT_SOURCES_NUMBER (16)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Process attributes.
+ */
+typedef struct 
+{
+    /**
+     * The stack size in bytes.
+     */
+    size_t stack;
+    
+    /**
+     * The heap size in bytes.
+     */
+    size_t heap;
+    
+    /**
+     * The priority.
+     */
+    int32_t priority;
+    
+    /**
+     * The address of .bss section.
+     */
+    size_t bss;
+    
+    /**
+     * The vector is called on the process exit.
+     */
+    void (*exit_vector)(void);
+    
+} s_prc_attr;
+
+/**
+ * Executes a user application main process.
+ *
+ * @param args an application arguments.
+ * @return the process exit code.
+ */
+int os_main(void* args);
+
+/**
+ * Allocates heap memory.
+ *
+ * @param heap  a heap, or NULL for the default heap.
+ * @param size  number of bytes to allocate.
+ * @param align an alignment of the memory.
+ * @return allocated memory address or NULL.
+ */
+void* heap_alloc(void* heap, size_t size, int32_t align);
+
+/**
+ * Frees heap memory.
+ *
+ * @param heap a heap, or NULL for the default heap.
+ * @param ptr  an allocated memory address or NULL.
+ */
+void heap_free(void* heap, void* ptr);
+
+/**
+ * Allocates an interrupt vector.
+ *
+ * @param source an interrupt source number.
+ * @param vector an interrupt vector.
+ * @return the interrupt resource, or RES_VOID if an error has been occurred.
+ */
+uint32_t int_alloc(int32_t source, void (*vector)(void));
+
+/**
+ * Frees an interrupt vector.
+ *
+ * @param res an interrupt resource.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t int_free(uint32_t res);
+
+/**
+ * Locks an interrupt source.
+ *
+ * @param res an interrupt resource.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t int_lock(uint32_t res);
+
+/**
+ * Unlocks an interrupt source.
+ *
+ * @param res an interrupt resource.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t int_unlock(uint32_t res);
+
+/**
+ * Clears an interrupt source request.
+ *
+ * @param res an interrupt resource.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t int_clear(uint32_t res);
+
+/**
+ * Sets an interrupt source request.
+ *
+ * @param res an interrupt resource.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t int_set(uint32_t res);
+
+/**
+ * Disables all maskable interrupts.
+ *
+ * @return 1 if the interrupts were enabled, or 0 otherwise.
+ */
+int32_t int_disable(void);
+
+/**
+ * Enables all maskable interrupts.
+ *
+ * @param status the value returned by int_disable.
+ */
+void int_enable(int32_t status);
+
+/**
+ * Creates a process.
+ *
+ * @param func a process main function.
+ * @param arg  an argument to be copied for the function.
+ * @param size the argument size in bytes.
+ * @param attr the process attributes.
+ * @return the process resource, or -1 if an error has been occurred.
+ */
+int32_t prc_create(int (*func)(void*), void* arg, size_t size, s_prc_attr* attr);
+
+/**
+ * Waits for a process termination.
+ *
+ * @param res a process resource.
+ * @return the value returned by the process main function, or -1 if an error has been occurred.
+ */
+int32_t prc_join(int32_t res);
+
+/**
+ * Returns the current process resource.
+ *
+ * @return the process resource.
+ */
+int32_t prc_id(void);
+
+/**
+ * Returns the stack of the current process.
+ *
+ * @param addr the lowest address of the stack for returning to.
+ * @param size the stack size in bytes for returning to.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t prc_stack(void** addr, size_t* size);
+
+/**
+ * Yields the current process.
+ */
+void prc_yield(void);
+
+/**
+ * Disables processes switching.
+ *
+ * @return 1 if the switching was enabled, or 0 otherwise.
+ */
+int32_t prc_disable(void);
+
+/**
+ * Enables processes switching.
+ *
+ * @param status the value returned by prc_disable.
+ */
+void prc_enable(int32_t status);
+
+/**
+ * Allocates a semaphore.
+ *
+ * A named semaphore is shared by all processes which allocate it with the name, 
+ * and its initial number of permits is set only if it does not exist. The named 
+ * semaphore is not removed when it is freed, and it keeps its permits.
+ *
+ * @param permits the initial number of permits.
+ * @param name    a semaphore name, or NULL.
+ * @return the semaphore resource, or RES_VOID if an error has been occurred.
+ */
+uint32_t sem_alloc(int32_t permits, const char* name);
+
+/**
+ * Frees a semaphore.
+ *
+ * The name of a named semaphore is not unlinked, so the semaphore allocated 
+ * with the name again has the permits left by the processes which freed it.
+ *
+ * @param res a semaphore resource.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t sem_free(uint32_t res);
+
+/**
+ * Acquires a semaphore permit.
+ *
+ * @param res     a semaphore resource.
+ * @param timeout a timeout in milliseconds, zero for polling, or SEM_INFINITY.
+ * @return SEM_OK, SEM_TIMEOUT, or SEM_ERROR if an error has been occurred.
+ */
+int32_t sem_lock(uint32_t res, uint32_t timeout);
+
+/**
+ * Releases a semaphore permit.
+ *
+ * @param res a semaphore resource.
+ * @return SEM_OK, or SEM_ERROR if an error has been occurred.
+ */
+int32_t sem_unlock(uint32_t res);
+
+/**
+ * Tests a semaphore state.
+ *
+ * @param res a semaphore resource.
+ * @return SEM_LOCKED if no permit is available, SEM_UNLOCKED, or SEM_ERROR.
+ */
+int32_t sem_locked(uint32_t res);
+
+/**
+ * Allocates a shared memory region.
+ *
+ * The region is shared by all processes which allocate it with the name. 
+ * A region which no other process holds is filled with zeros, so the content 
+ * left by crashed processes is discarded.
+ *
+ * @param name a region name.
+ * @param size the region size in bytes.
+ * @return the region resource, or RES_VOID if an error has been occurred.
+ */
+uint32_t shm_alloc(const char* name, size_t size);
+
+/**
+ * Returns the address of a shared memory region.
+ *
+ * @param res a region resource.
+ * @return the region address in the current process, or NULL if an error has been occurred.
+ */
+void* shm_addr(uint32_t res);
+
+/**
+ * Frees a shared memory region.
+ *
+ * The region is removed when the last process which holds it frees it.
+ *
+ * @param res a region resource.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t shm_free(uint32_t res);
+
+/**
+ * Returns the core time.
+ *
+ * @return time in nanoseconds.
+ */
+uint64_t time_core_n(void);
+
+/**
+ * Sleeps in microseconds.
+ *
+ * @param micros a time to sleep.
+ */
+void sleep_u(uint32_t micros);
+
+/**
+ * Sleeps in milliseconds.
+ *
+ * @param millis a time to sleep.
+ */
+void sleep_m(uint32_t millis);
+
+/**
+ * Returns the system name.
+ *
+ * @param name a buffer for the name.
+ * @param size the buffer size in bytes.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t sys_getname(char* name, size_t size);
+
+/**
+ * Discovers a service of a system.
+ *
+ * @param name    a system name.
+ * @param service a service name.
+ * @param timeout a timeout in milliseconds.
+ * @return the service resource, or RES_VOID if an error has been occurred.
+ */
+uint32_t msg_discover(const char* name, const char* service, uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OS_H_
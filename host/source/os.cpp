@@ -0,0 +1,1013 @@
+/**
+ * Host port of the operating system interface.
+ *
+ * The port emulates one processor. All maskable interrupts and processes
+ * switching are two global locks owned by the process which has disabled them,
+ * and a process blocked on a semaphore releases the locks it owns until it
+ * resumes as a kernel does switching the process out. Interrupt vectors are
+ * executed by the interrupt controller thread, which owns the interrupts lock
+ * while a vector is being executed.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "os.h"
+#include "mapi.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <sched.h>
+#include <dlfcn.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <stdio.h>
+
+namespace
+{
+    /**
+     * The number of processes.
+     */
+    const int32_t PROCESSES_NUMBER = 1024;
+
+    /**
+     * The number of semaphores.
+     */
+    const uint32_t SEMAPHORES_NUMBER = 4096;
+
+    /**
+     * The number of shared memory regions.
+     */
+    const uint32_t REGIONS_NUMBER = 64;
+
+    /**
+     * The maximum length of a host name of a shared object.
+     */
+    const size_t NAME_LENGTH = 64;
+
+    /**
+     * Host stack size reserved over a requested process stack size.
+     */
+    const size_t STACK_RESERVE = 0x10000;
+
+    /**
+     * A lock of a global processor state.
+     */
+    struct Lock
+    {
+        pthread_mutex_t mutex;
+        pthread_cond_t  cond;
+        pthread_t       owner;
+        bool            isOwned;
+    };
+
+    /**
+     * An interrupt source.
+     */
+    struct Source
+    {
+        void (*vector)(void);
+        bool isAllocated;
+        bool isLocked;
+        bool isPending;
+    };
+
+    /**
+     * A process.
+     */
+    struct Process
+    {
+        pthread_t thread;
+        int (*func)(void*);
+        void* arg;
+        bool isAllocated;
+    };
+
+    /**
+     * A semaphore.
+     */
+    struct Semaphore
+    {
+        pthread_mutex_t mutex;
+        pthread_cond_t  cond;
+        int32_t         permits;
+        sem_t*          named;
+        char            name[NAME_LENGTH];
+    };
+
+    /**
+     * A shared memory region.
+     */
+    struct Region
+    {
+        void*  addr;
+        size_t size;
+        int    fd;
+        char   name[NAME_LENGTH];
+    };
+
+    /**
+     * All maskable interrupts lock.
+     */
+    Lock interrupts_ = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, pthread_t(), false };
+
+    /**
+     * Processes switching lock.
+     */
+    Lock processes_ = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, pthread_t(), false };
+
+    /**
+     * Interrupt sources.
+     */
+    Source sources_[INT_SOURCES_NUMBER];
+
+    /**
+     * Interrupt sources mutex.
+     */
+    pthread_mutex_t sourcesMutex_ = PTHREAD_MUTEX_INITIALIZER;
+
+    /**
+     * Interrupt sources requests condition.
+     */
+    pthread_cond_t sourcesCond_ = PTHREAD_COND_INITIALIZER;
+
+    /**
+     * Processes table, where the zero process is the main process.
+     */
+    Process table_[PROCESSES_NUMBER];
+
+    /**
+     * Processes table mutex.
+     */
+    pthread_mutex_t tableMutex_ = PTHREAD_MUTEX_INITIALIZER;
+
+    /**
+     * The current process key.
+     */
+    pthread_key_t process_;
+
+    /**
+     * Semaphores table.
+     */
+    Semaphore* semaphores_[SEMAPHORES_NUMBER];
+
+    /**
+     * Semaphores table mutex.
+     */
+    pthread_mutex_t semaphoresMutex_ = PTHREAD_MUTEX_INITIALIZER;
+
+    /**
+     * Shared memory regions table.
+     */
+    Region* regions_[REGIONS_NUMBER];
+
+    /**
+     * Shared memory regions table mutex.
+     */
+    pthread_mutex_t regionsMutex_ = PTHREAD_MUTEX_INITIALIZER;
+
+    /**
+     * Acquires a lock.
+     *
+     * @param lock the lock.
+     * @return 1 if the lock has been acquired, or 0 if the caller owns the lock.
+     */
+    int32_t acquire(Lock& lock)
+    {
+        pthread_t const self = pthread_self();
+        int32_t res = 1;
+        pthread_mutex_lock(&lock.mutex);
+        if(lock.isOwned && pthread_equal(lock.owner, self))
+        {
+            res = 0;
+        }
+        else
+        {
+            while(lock.isOwned)
+            {
+                pthread_cond_wait(&lock.cond, &lock.mutex);
+            }
+            lock.isOwned = true;
+            lock.owner = self;
+        }
+        pthread_mutex_unlock(&lock.mutex);
+        return res;
+    }
+
+    /**
+     * Releases a lock.
+     *
+     * @param lock the lock.
+     */
+    void release(Lock& lock)
+    {
+        pthread_mutex_lock(&lock.mutex);
+        lock.isOwned = false;
+        pthread_cond_broadcast(&lock.cond);
+        pthread_mutex_unlock(&lock.mutex);
+    }
+
+    /**
+     * Releases a lock if the caller owns it.
+     *
+     * @param lock the lock.
+     * @return true if the lock has been released.
+     */
+    bool suspend(Lock& lock)
+    {
+        bool res = false;
+        pthread_mutex_lock(&lock.mutex);
+        if(lock.isOwned && pthread_equal(lock.owner, pthread_self()))
+        {
+            lock.isOwned = false;
+            pthread_cond_broadcast(&lock.cond);
+            res = true;
+        }
+        pthread_mutex_unlock(&lock.mutex);
+        return res;
+    }
+
+    /**
+     * Acquires a lock released by suspend function.
+     *
+     * @param lock        the lock.
+     * @param isSuspended the value returned by suspend function.
+     */
+    void resume(Lock& lock, bool const isSuspended)
+    {
+        if(isSuspended)
+        {
+            acquire(lock);
+        }
+    }
+
+    /**
+     * Returns a semaphore.
+     *
+     * @param res a semaphore resource.
+     * @return the semaphore, or NULL.
+     */
+    Semaphore* getSemaphore(uint32_t const res)
+    {
+        return res < SEMAPHORES_NUMBER ? semaphores_[res] : NULL;
+    }
+
+    /**
+     * Makes a host name of a shared object.
+     *
+     * @param name   a system name of the object.
+     * @param buffer a buffer of NAME_LENGTH bytes for the host name.
+     * @return true if the name fits the buffer.
+     */
+    bool makeName(const char* const name, char* const buffer)
+    {
+        int const length = snprintf(buffer, NAME_LENGTH, "/%s", name);
+        return length > 1 && static_cast<size_t>(length) < NAME_LENGTH ? true : false;
+    }
+
+    /**
+     * Acquires a permit of a named semaphore.
+     *
+     * @param sem     a named semaphore.
+     * @param timeout a timeout in milliseconds, zero for polling, or SEM_INFINITY.
+     * @return SEM_OK, SEM_TIMEOUT, or SEM_ERROR if an error has been occurred.
+     */
+    int32_t lockNamed(Semaphore* const sem, uint32_t const timeout)
+    {
+        if(sem_trywait(sem->named) == 0) return SEM_OK;
+        if(timeout == 0) return SEM_TIMEOUT;
+        // Host named semaphores wait on the real time clock
+        struct timespec time;
+        clock_gettime(CLOCK_REALTIME, &time);
+        if(timeout != SEM_INFINITY)
+        {
+            time.tv_sec += timeout / 1000;
+            time.tv_nsec += static_cast<long>(timeout % 1000) * 1000000L;
+            if(time.tv_nsec >= 1000000000L)
+            {
+                time.tv_sec++;
+                time.tv_nsec -= 1000000000L;
+            }
+        }
+        bool const isInterrupts = suspend(interrupts_);
+        bool const isProcesses = suspend(processes_);
+        int error;
+        do
+        {
+            error = timeout == SEM_INFINITY ? sem_wait(sem->named) : sem_timedwait(sem->named, &time);
+        }
+        while(error != 0 && errno == EINTR);
+        int32_t const result = error == 0 ? SEM_OK : errno == ETIMEDOUT ? SEM_TIMEOUT : SEM_ERROR;
+        resume(processes_, isProcesses);
+        resume(interrupts_, isInterrupts);
+        return result;
+    }
+
+    /**
+     * Executes requested interrupt vectors.
+     *
+     * @param arg unused.
+     * @return NULL.
+     */
+    void* controller(void*)
+    {
+        while(true)
+        {
+            pthread_mutex_lock(&sourcesMutex_);
+            bool isRequested = false;
+            while( not isRequested )
+            {
+                for(int32_t i=0; i<INT_SOURCES_NUMBER; i++)
+                {
+                    Source const& source = sources_[i];
+                    if(source.isAllocated && source.isPending && not source.isLocked)
+                    {
+                        isRequested = true;
+                        break;
+                    }
+                }
+                if( not isRequested )
+                {
+                    pthread_cond_wait(&sourcesCond_, &sourcesMutex_);
+                }
+            }
+            pthread_mutex_unlock(&sourcesMutex_);
+            // Wait for the interrupts enabling and take the request with the highest priority
+            acquire(interrupts_);
+            void (*vector)(void) = NULL;
+            pthread_mutex_lock(&sourcesMutex_);
+            for(int32_t i=0; i<INT_SOURCES_NUMBER; i++)
+            {
+                Source& source = sources_[i];
+                if(source.isAllocated && source.isPending && not source.isLocked)
+                {
+                    source.isPending = false;
+                    vector = source.vector;
+                    break;
+                }
+            }
+            pthread_mutex_unlock(&sourcesMutex_);
+            if(vector != NULL)
+            {
+                vector();
+            }
+            release(interrupts_);
+        }
+        return NULL;
+    }
+
+    /**
+     * Returns a signal set of interrupt sources.
+     *
+     * @param set the signal set to be filled.
+     */
+    void getSignals(sigset_t* const set)
+    {
+        sigemptyset(set);
+        for(int32_t i=0; i<INT_SOURCES_NUMBER && SIGRTMIN + i <= SIGRTMAX; i++)
+        {
+            sigaddset(set, SIGRTMIN + i);
+        }
+    }
+
+    /**
+     * Requests interrupt sources on receiving their signals.
+     *
+     * @param arg unused.
+     * @return NULL.
+     */
+    void* receiver(void*)
+    {
+        sigset_t set;
+        getSignals(&set);
+        while(true)
+        {
+            int signal;
+            if(sigwait(&set, &signal) != 0) continue;
+            int_set( static_cast<uint32_t>(signal - SIGRTMIN) );
+        }
+        return NULL;
+    }
+
+    /**
+     * Executes a process.
+     *
+     * @param arg the process.
+     * @return the value returned by the process main function.
+     */
+    void* execute(void* const arg)
+    {
+        Process* const process = static_cast<Process*>(arg);
+        pthread_setspecific(process_, process);
+        intptr_t const res = process->func(process->arg);
+        return reinterpret_cast<void*>(res);
+    }
+}
+
+/**
+ * The main entry point of the host process.
+ *
+ * @param argc unused.
+ * @param argv the arguments.
+ * @return the user application exit code.
+ */
+int main(int, char** argv)
+{
+    // Block the interrupt signals in all threads for the receiver thread only
+    sigset_t set;
+    getSignals(&set);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+    pthread_key_create(&process_, NULL);
+    table_[0].thread = pthread_self();
+    table_[0].isAllocated = true;
+    pthread_setspecific(process_, &table_[0]);
+    pthread_t thread;
+    if(pthread_create(&thread, NULL, controller, NULL) != 0) return -1;
+    pthread_detach(thread);
+    if(pthread_create(&thread, NULL, receiver, NULL) != 0) return -1;
+    pthread_detach(thread);
+    return os_main(argv);
+}
+
+/**
+ * Allocates heap memory.
+ */
+void* heap_alloc(void*, size_t const size, int32_t const align)
+{
+    void* ptr = NULL;
+    size_t const alignment = static_cast<size_t>(align) < sizeof(void*) ? sizeof(void*) : static_cast<size_t>(align);
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : NULL;
+}
+
+/**
+ * Frees heap memory.
+ */
+void heap_free(void*, void* const ptr)
+{
+    free(ptr);
+}
+
+/**
+ * Allocates an interrupt vector.
+ */
+uint32_t int_alloc(int32_t const source, void (*vector)(void))
+{
+    if(source < 0 || source >= INT_SOURCES_NUMBER || vector == NULL) return RES_VOID;
+    uint32_t res = RES_VOID;
+    pthread_mutex_lock(&sourcesMutex_);
+    if( not sources_[source].isAllocated )
+    {
+        sources_[source].vector = vector;
+        sources_[source].isAllocated = true;
+        sources_[source].isLocked = false;
+        sources_[source].isPending = false;
+        res = static_cast<uint32_t>(source);
+    }
+    pthread_mutex_unlock(&sourcesMutex_);
+    return res;
+}
+
+/**
+ * Frees an interrupt vector.
+ */
+int32_t int_free(uint32_t const res)
+{
+    if(res >= INT_SOURCES_NUMBER) return OSE_ERROR;
+    pthread_mutex_lock(&sourcesMutex_);
+    sources_[res].isAllocated = false;
+    sources_[res].vector = NULL;
+    pthread_mutex_unlock(&sourcesMutex_);
+    return OSE_OK;
+}
+
+/**
+ * Locks an interrupt source.
+ */
+int32_t int_lock(uint32_t const res)
+{
+    if(res >= INT_SOURCES_NUMBER) return OSE_ERROR;
+    pthread_mutex_lock(&sourcesMutex_);
+    sources_[res].isLocked = true;
+    pthread_mutex_unlock(&sourcesMutex_);
+    return OSE_OK;
+}
+
+/**
+ * Unlocks an interrupt source.
+ */
+int32_t int_unlock(uint32_t const res)
+{
+    if(res >= INT_SOURCES_NUMBER) return OSE_ERROR;
+    pthread_mutex_lock(&sourcesMutex_);
+    sources_[res].isLocked = false;
+    pthread_cond_signal(&sourcesCond_);
+    pthread_mutex_unlock(&sourcesMutex_);
+    return OSE_OK;
+}
+
+/**
+ * Clears an interrupt source request.
+ */
+int32_t int_clear(uint32_t const res)
+{
+    if(res >= INT_SOURCES_NUMBER) return OSE_ERROR;
+    pthread_mutex_lock(&sourcesMutex_);
+    sources_[res].isPending = false;
+    pthread_mutex_unlock(&sourcesMutex_);
+    return OSE_OK;
+}
+
+/**
+ * Sets an interrupt source request.
+ */
+int32_t int_set(uint32_t const res)
+{
+    if(res >= INT_SOURCES_NUMBER) return OSE_ERROR;
+    int32_t error = OSE_ERROR;
+    pthread_mutex_lock(&sourcesMutex_);
+    if(sources_[res].isAllocated)
+    {
+        sources_[res].isPending = true;
+        pthread_cond_signal(&sourcesCond_);
+        error = OSE_OK;
+    }
+    pthread_mutex_unlock(&sourcesMutex_);
+    return error;
+}
+
+/**
+ * Disables all maskable interrupts.
+ */
+int32_t int_disable(void)
+{
+    return acquire(interrupts_);
+}
+
+/**
+ * Enables all maskable interrupts.
+ */
+void int_enable(int32_t const status)
+{
+    if(status != 0)
+    {
+        release(interrupts_);
+    }
+}
+
+/**
+ * Creates a process.
+ */
+int32_t prc_create(int (*func)(void*), void* const arg, size_t const size, s_prc_attr* const attr)
+{
+    if(func == NULL || attr == NULL) return -1;
+    void* const copy = malloc(size == 0 ? 1 : size);
+    if(copy == NULL) return -1;
+    if(arg != NULL)
+    {
+        memcpy(copy, arg, size);
+    }
+    int32_t res = -1;
+    pthread_mutex_lock(&tableMutex_);
+    for(int32_t i=1; i<PROCESSES_NUMBER; i++)
+    {
+        if(table_[i].isAllocated) continue;
+        res = i;
+        break;
+    }
+    if(res > 0)
+    {
+        Process& process = table_[res];
+        process.func = func;
+        process.arg = copy;
+        size_t const minimum = static_cast<size_t>(PTHREAD_STACK_MIN);
+        size_t const stack = attr->stack < minimum ? minimum : attr->stack;
+        pthread_attr_t attrs;
+        pthread_attr_init(&attrs);
+        pthread_attr_setstacksize(&attrs, stack + STACK_RESERVE);
+        if(pthread_create(&process.thread, &attrs, execute, &process) == 0)
+        {
+            process.isAllocated = true;
+        }
+        else
+        {
+            res = -1;
+        }
+        pthread_attr_destroy(&attrs);
+    }
+    pthread_mutex_unlock(&tableMutex_);
+    if(res < 0)
+    {
+        free(copy);
+    }
+    return res;
+}
+
+/**
+ * Waits for a process termination.
+ */
+int32_t prc_join(int32_t const res)
+{
+    if(res <= 0 || res >= PROCESSES_NUMBER) return -1;
+    pthread_mutex_lock(&tableMutex_);
+    bool const isAllocated = table_[res].isAllocated;
+    pthread_t const thread = table_[res].thread;
+    pthread_mutex_unlock(&tableMutex_);
+    if( not isAllocated ) return -1;
+    // The joining process is switched out as it is blocked on a semaphore
+    bool const isInterrupts = suspend(interrupts_);
+    bool const isProcesses = suspend(processes_);
+    void* value = NULL;
+    int32_t const error = pthread_join(thread, &value);
+    resume(processes_, isProcesses);
+    resume(interrupts_, isInterrupts);
+    if(error != 0) return -1;
+    pthread_mutex_lock(&tableMutex_);
+    free(table_[res].arg);
+    table_[res].arg = NULL;
+    table_[res].isAllocated = false;
+    pthread_mutex_unlock(&tableMutex_);
+    return static_cast<int32_t>( reinterpret_cast<intptr_t>(value) );
+}
+
+/**
+ * Returns the current process resource.
+ */
+int32_t prc_id(void)
+{
+    Process* const process = static_cast<Process*>( pthread_getspecific(process_) );
+    return process == NULL ? -1 : static_cast<int32_t>(process - table_);
+}
+
+/**
+ * Returns the stack of the current process.
+ *
+ * @param addr the lowest address of the stack for returning to.
+ * @param size the stack size in bytes for returning to.
+ * @return OSE_OK, or OSE_ERROR if an error has been occurred.
+ */
+int32_t prc_stack(void** const addr, size_t* const size)
+{
+    if(addr == NULL || size == NULL) return OSE_ERROR;
+    pthread_attr_t attrs;
+    if(pthread_getattr_np(pthread_self(), &attrs) != 0) return OSE_ERROR;
+    int const error = pthread_attr_getstack(&attrs, addr, size);
+    pthread_attr_destroy(&attrs);
+    return error == 0 ? OSE_OK : OSE_ERROR;
+}
+
+/**
+ * Yields the current process.
+ */
+void prc_yield(void)
+{
+    sched_yield();
+}
+
+/**
+ * Disables processes switching.
+ */
+int32_t prc_disable(void)
+{
+    return acquire(processes_);
+}
+
+/**
+ * Enables processes switching.
+ */
+void prc_enable(int32_t const status)
+{
+    if(status != 0)
+    {
+        release(processes_);
+    }
+}
+
+/**
+ * Allocates a semaphore.
+ */
+uint32_t sem_alloc(int32_t const permits, const char* const name)
+{
+    if(permits < 0) return RES_VOID;
+    Semaphore* const sem = new Semaphore;
+    sem->named = NULL;
+    sem->name[0] = '\0';
+    // A named semaphore is shared by all host processes which allocate it
+    if(name != NULL)
+    {
+        if( not makeName(name, sem->name) )
+        {
+            delete sem;
+            return RES_VOID;
+        }
+        sem->named = sem_open(sem->name, O_CREAT, 0600, static_cast<unsigned>(permits));
+        if(sem->named == SEM_FAILED)
+        {
+            delete sem;
+            return RES_VOID;
+        }
+    }
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sem->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&sem->mutex, NULL);
+    sem->permits = permits;
+    uint32_t res = RES_VOID;
+    pthread_mutex_lock(&semaphoresMutex_);
+    for(uint32_t i=0; i<SEMAPHORES_NUMBER; i++)
+    {
+        if(semaphores_[i] != NULL) continue;
+        semaphores_[i] = sem;
+        res = i;
+        break;
+    }
+    pthread_mutex_unlock(&semaphoresMutex_);
+    if(res == RES_VOID)
+    {
+        if(sem->named != NULL)
+        {
+            sem_close(sem->named);
+        }
+        pthread_cond_destroy(&sem->cond);
+        pthread_mutex_destroy(&sem->mutex);
+        delete sem;
+    }
+    return res;
+}
+
+/**
+ * Frees a semaphore.
+ */
+int32_t sem_free(uint32_t const res)
+{
+    if(res >= SEMAPHORES_NUMBER) return OSE_ERROR;
+    pthread_mutex_lock(&semaphoresMutex_);
+    Semaphore* const sem = semaphores_[res];
+    semaphores_[res] = NULL;
+    pthread_mutex_unlock(&semaphoresMutex_);
+    if(sem == NULL) return OSE_ERROR;
+    // The name is kept, as other processes might open the semaphore again
+    if(sem->named != NULL)
+    {
+        sem_close(sem->named);
+    }
+    pthread_cond_destroy(&sem->cond);
+    pthread_mutex_destroy(&sem->mutex);
+    delete sem;
+    return OSE_OK;
+}
+
+/**
+ * Acquires a semaphore permit.
+ */
+int32_t sem_lock(uint32_t const res, uint32_t const timeout)
+{
+    Semaphore* const sem = getSemaphore(res);
+    if(sem == NULL) return SEM_ERROR;
+    if(sem->named != NULL) return lockNamed(sem, timeout);
+    pthread_mutex_lock(&sem->mutex);
+    if(sem->permits > 0 || timeout == 0)
+    {
+        int32_t const error = sem->permits > 0 ? SEM_OK : SEM_TIMEOUT;
+        if(error == SEM_OK)
+        {
+            sem->permits--;
+        }
+        pthread_mutex_unlock(&sem->mutex);
+        return error;
+    }
+    pthread_mutex_unlock(&sem->mutex);
+    // The process is switched out, so its global locks are released until it resumes
+    bool const isInterrupts = suspend(interrupts_);
+    bool const isProcesses = suspend(processes_);
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    if(timeout != SEM_INFINITY)
+    {
+        time.tv_sec += timeout / 1000;
+        time.tv_nsec += static_cast<long>(timeout % 1000) * 1000000L;
+        if(time.tv_nsec >= 1000000000L)
+        {
+            time.tv_sec++;
+            time.tv_nsec -= 1000000000L;
+        }
+    }
+    int32_t error = SEM_OK;
+    pthread_mutex_lock(&sem->mutex);
+    while(sem->permits == 0)
+    {
+        if(timeout == SEM_INFINITY)
+        {
+            pthread_cond_wait(&sem->cond, &sem->mutex);
+        }
+        else if(pthread_cond_timedwait(&sem->cond, &sem->mutex, &time) == ETIMEDOUT)
+        {
+            error = SEM_TIMEOUT;
+            break;
+        }
+    }
+    if(error == SEM_OK)
+    {
+        sem->permits--;
+    }
+    pthread_mutex_unlock(&sem->mutex);
+    resume(processes_, isProcesses);
+    resume(interrupts_, isInterrupts);
+    return error;
+}
+
+/**
+ * Releases a semaphore permit.
+ */
+int32_t sem_unlock(uint32_t const res)
+{
+    Semaphore* const sem = getSemaphore(res);
+    if(sem == NULL) return SEM_ERROR;
+    if(sem->named != NULL) return sem_post(sem->named) == 0 ? SEM_OK : SEM_ERROR;
+    pthread_mutex_lock(&sem->mutex);
+    sem->permits++;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->mutex);
+    return SEM_OK;
+}
+
+/**
+ * Tests a semaphore state.
+ */
+int32_t sem_locked(uint32_t const res)
+{
+    Semaphore* const sem = getSemaphore(res);
+    if(sem == NULL) return SEM_ERROR;
+    if(sem->named != NULL)
+    {
+        int value;
+        if(sem_getvalue(sem->named, &value) != 0) return SEM_ERROR;
+        return value <= 0 ? SEM_LOCKED : SEM_UNLOCKED;
+    }
+    pthread_mutex_lock(&sem->mutex);
+    int32_t const state = sem->permits == 0 ? SEM_LOCKED : SEM_UNLOCKED;
+    pthread_mutex_unlock(&sem->mutex);
+    return state;
+}
+
+/**
+ * Allocates a shared memory region.
+ */
+uint32_t shm_alloc(const char* const name, size_t const size)
+{
+    if(name == NULL || size == 0) return RES_VOID;
+    Region* const region = new Region;
+    if( not makeName(name, region->name) )
+    {
+        delete region;
+        return RES_VOID;
+    }
+    int const fd = shm_open(region->name, O_RDWR | O_CREAT, 0600);
+    if(fd < 0)
+    {
+        delete region;
+        return RES_VOID;
+    }
+    // Each process holds a shared lock of the object, so an object which is not locked 
+    // is new or left by crashed processes, and it is filled with zeros by truncating
+    if(flock(fd, LOCK_EX | LOCK_NB) == 0 && ftruncate(fd, 0) != 0)
+    {
+        close(fd);
+        delete region;
+        return RES_VOID;
+    }
+    region->size = size;
+    region->fd = fd;
+    region->addr = MAP_FAILED;
+    if(flock(fd, LOCK_SH) == 0 && ftruncate(fd, static_cast<off_t>(size)) == 0)
+    {
+        region->addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if(region->addr == MAP_FAILED)
+    {
+        close(fd);
+        delete region;
+        return RES_VOID;
+    }
+    uint32_t res = RES_VOID;
+    pthread_mutex_lock(&regionsMutex_);
+    for(uint32_t i=0; i<REGIONS_NUMBER; i++)
+    {
+        if(regions_[i] != NULL) continue;
+        regions_[i] = region;
+        res = i;
+        break;
+    }
+    pthread_mutex_unlock(&regionsMutex_);
+    if(res == RES_VOID)
+    {
+        munmap(region->addr, region->size);
+        close(region->fd);
+        delete region;
+    }
+    return res;
+}
+
+/**
+ * Returns the address of a shared memory region.
+ */
+void* shm_addr(uint32_t const res)
+{
+    if(res >= REGIONS_NUMBER) return NULL;
+    pthread_mutex_lock(&regionsMutex_);
+    Region* const region = regions_[res];
+    pthread_mutex_unlock(&regionsMutex_);
+    return region != NULL ? region->addr : NULL;
+}
+
+/**
+ * Frees a shared memory region.
+ */
+int32_t shm_free(uint32_t const res)
+{
+    if(res >= REGIONS_NUMBER) return OSE_ERROR;
+    pthread_mutex_lock(&regionsMutex_);
+    Region* const region = regions_[res];
+    regions_[res] = NULL;
+    pthread_mutex_unlock(&regionsMutex_);
+    if(region == NULL) return OSE_ERROR;
+    // The name is removed by the last process which holds the object
+    munmap(region->addr, region->size);
+    if(flock(region->fd, LOCK_EX | LOCK_NB) == 0)
+    {
+        shm_unlink(region->name);
+    }
+    close(region->fd);
+    delete region;
+    return OSE_OK;
+}
+
+/**
+ * Returns the core time.
+ */
+uint64_t time_core_n(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000ull + static_cast<uint64_t>(time.tv_nsec);
+}
+
+/**
+ * Sleeps in microseconds.
+ */
+void sleep_u(uint32_t const micros)
+{
+    struct timespec time;
+    time.tv_sec = micros / 1000000;
+    time.tv_nsec = static_cast<long>(micros % 1000000) * 1000L;
+    while(nanosleep(&time, &time) != 0 && errno == EINTR);
+}
+
+/**
+ * Sleeps in milliseconds.
+ */
+void sleep_m(uint32_t const millis)
+{
+    struct timespec time;
+    time.tv_sec = millis / 1000;
+    time.tv_nsec = static_cast<long>(millis % 1000) * 1000000L;
+    while(nanosleep(&time, &time) != 0 && errno == EINTR);
+}
+
+/**
+ * Returns the system name.
+ */
+int32_t sys_getname(char* const name, size_t const size)
+{
+    static const char host[] = "host";
+    if(name == NULL || size < sizeof(host)) return OSE_ERROR;
+    memcpy(name, host, sizeof(host));
+    return OSE_OK;
+}
+
+/**
+ * Discovers a service of a system.
+ */
+uint32_t msg_discover(const char* const name, const char* const service, uint32_t)
+{
+    if(name == NULL || service == NULL) return RES_VOID;
+    return strcmp(service, "os") == 0 ? 0 : RES_VOID;
+}
+
+/**
+ * Loads a module after the current one.
+ */
+int32_t mapi_loadafterme(uint32_t const res, const char* const path, void*)
+{
+    if(res != 0) return OSE_ERROR;
+    if(path == NULL) return OSE_ERROR;
+    return dlopen(path, RTLD_NOW | RTLD_GLOBAL) != NULL ? OSE_OK : OSE_ERROR;
+}
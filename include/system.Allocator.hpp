@@ -10,6 +10,16 @@
 
 #include "Types.hpp"
 
+/**
+ * The size of the allocator arenas in bytes, which must be a power of two.
+ *
+ * Memory blocks bigger than an eighth of the size are requested directly 
+ * from the operating system heap.
+ */
+#ifndef SYSTEM_ALLOCATOR_ARENA_SIZE
+#define SYSTEM_ALLOCATOR_ARENA_SIZE 0x4000
+#endif
+
 namespace local
 {
     namespace system
@@ -19,6 +29,59 @@ namespace local
         
         public:
         
+            /**
+             * The number of free block size classes.
+             */
+            static const int32 CLASSES_NUMBER = 16;
+        
+            /**
+             * Free space of the allocator arenas.
+             */
+            struct FreeSpace
+            {
+                /**
+                 * The number of arenas.
+                 */
+                uint32 arenas;
+                
+                /**
+                 * The size of arenas in bytes.
+                 */
+                size_t size;
+                
+                /**
+                 * The number of bytes of the used blocks.
+                 */
+                size_t used;
+                
+                /**
+                 * The number of bytes of the free blocks.
+                 */
+                size_t free;
+                
+                /**
+                 * The size of the largest free block in bytes.
+                 */
+                size_t largest;
+                
+                /**
+                 * The number of free blocks.
+                 */
+                uint32 blocks;
+                
+                /**
+                 * The number of free blocks of each size class, where the class N
+                 * has blocks of 2^(N+4) to 2^(N+5)-1 bytes, the first class also 
+                 * has smaller blocks, and the last class also has bigger blocks.
+                 */
+                uint32 classes[CLASSES_NUMBER];
+                
+                /**
+                 * The free bytes out of the largest free block in per mille of all free bytes.
+                 */
+                int32 fragmentation;
+            };
+        
             /**
              * Allocates memory.
              *
@@ -33,6 +96,310 @@ namespace local
              * @param ptr address of allocated memory block or a null pointer.
              */      
             static void free(void* ptr);
+            
+            /**
+             * Changes the size of an allocated memory.
+             *
+             * The memory is resized in place if it is shrunk, or if it is grown 
+             * into the free memory following it. Otherwise, the memory is moved 
+             * to a new block, and the old block is freed. A grown memory is moved 
+             * to a block with a quarter more room, so a buffer growing by small 
+             * steps is moved a logarithmic number of times.
+             *
+             * @param ptr  address of allocated memory block, or a null pointer for allocating.
+             * @param size number of bytes of the resized memory.
+             * @return resized memory address, or a null pointer if the memory is not resized.
+             */
+            static void* reallocate(void* ptr, size_t size);
+            
+            /**
+             * Walks the arenas and collects their free space.
+             *
+             * Each arena is walked in its own critical section, so the allocator is blocked 
+             * for walking one arena at most, and the result is not a snapshot if the memory 
+             * is being allocated while the arenas are walked. The blocks requested directly 
+             * from the operating system heap are not walked.
+             *
+             * @param space the free space.
+             */
+            static void getFreeSpace(FreeSpace& space);
+            
+        private:
+        
+            /**
+             * Memory requested from the operating system heap for small chunks.
+             *
+             * An arena is split into chunks, which are followed by an empty used chunk as the arena end.
+             */
+            struct Arena
+            {
+                /**
+                 * The next arena.
+                 */
+                Arena* next;
+                
+                /**
+                 * The previous arena.
+                 */
+                Arena* prev;
+                
+                /**
+                 * The arena size in bytes.
+                 */
+                size_t size;
+            };
+            
+            /**
+             * Boundary tags of a chunk of an arena, or the header of a block requested directly.
+             */
+            struct Chunk
+            {
+                /**
+                 * The chunk size including the tags in bytes, and the USED and DIRECT flags.
+                 */
+                size_t size;
+                
+                /**
+                 * The previous chunk size in bytes, or zero for the first chunk of an arena.
+                 */
+                size_t previous;
+            };
+            
+            /**
+             * A free chunk linked to the free chunks list of its bin.
+             */
+            struct FreeChunk : public Chunk
+            {
+                /**
+                 * The next free chunk.
+                 */
+                FreeChunk* next;
+                
+                /**
+                 * The previous free chunk.
+                 */
+                FreeChunk* prev;
+            };
+            
+            /**
+             * Allocates a chunk of the arenas.
+             *
+             * @param size the chunk size in bytes.
+             * @return the chunk, or NULL if the arenas have no free chunk of the size.
+             */
+            static Chunk* allocateChunk(size_t size);
+            
+            /**
+             * Frees a chunk, and merges it with the adjacent free chunks.
+             *
+             * @param chunk a used chunk.
+             * @return an empty arena unlinked for returning to the operating system, or NULL.
+             */
+            static Arena* freeChunk(Chunk* chunk);
+            
+            /**
+             * Splits off the tail of a used chunk, and frees the tail.
+             *
+             * @param chunk a used chunk.
+             * @param size  the new chunk size in bytes.
+             */
+            static void splitChunk(Chunk* chunk, size_t size);
+            
+            /**
+             * Requests a new arena from the operating system heap.
+             *
+             * @return the arena, or NULL if no memory is available.
+             */
+            static Arena* createArena();
+            
+            /**
+             * Links a new arena, and its free chunk of the whole arena.
+             *
+             * @param arena an arena.
+             */
+            static void addArena(Arena* arena);
+            
+            /**
+             * Requests a block directly from the operating system heap.
+             *
+             * @param size the chunk size of the block in bytes.
+             * @return the block chunk, or NULL if no memory is available.
+             */
+            static Chunk* allocateDirect(size_t size);
+            
+            /**
+             * Links a chunk to the free chunks list of its bin.
+             *
+             * @param chunk a chunk.
+             */
+            static void link(Chunk* chunk);
+            
+            /**
+             * Unlinks a chunk from the free chunks list of its bin.
+             *
+             * @param chunk a free chunk.
+             */
+            static void unlink(FreeChunk* chunk);
+            
+            /**
+             * Returns the chunk size of a memory size.
+             *
+             * @param size a memory size in bytes.
+             * @return the chunk size in bytes, or zero if the size is too big.
+             */
+            static size_t toChunkSize(size_t size);
+            
+            /**
+             * Returns the bin of free chunks of a size.
+             *
+             * @param size a chunk size in bytes.
+             * @return the bin index.
+             */
+            static int32 getBin(size_t size);
+            
+            /**
+             * Returns the first bin which has free chunks.
+             *
+             * @param bin the bin index the search is started from.
+             * @return the bin index, or -1 if all the bins from the given one are empty.
+             */
+            static int32 findBin(int32 bin);
+            
+            /**
+             * Returns the next chunk of an arena.
+             *
+             * @param chunk a chunk.
+             * @return the next chunk.
+             */
+            static Chunk* getNext(Chunk* chunk);
+            
+            /**
+             * Returns the chunk size.
+             *
+             * @param chunk a chunk.
+             * @return the chunk size in bytes.
+             */
+            static size_t getSize(const Chunk* chunk);
+            
+            /**
+             * Tests if a chunk is used.
+             *
+             * @param chunk a chunk.
+             * @return true if the chunk is used.
+             */
+            static bool isUsed(const Chunk* chunk);
+            
+            /**
+             * Tests if a chunk is a block requested directly from the operating system heap.
+             *
+             * @param chunk a used chunk.
+             * @return true if the chunk is a direct block.
+             */
+            static bool isDirect(const Chunk* chunk);
+            
+            /**
+             * Tests if a free chunk takes the whole arena.
+             *
+             * @param chunk a free chunk.
+             * @return true if the arena of the chunk is empty.
+             */
+            static bool isEmpty(Chunk* chunk);
+            
+            /**
+             * Returns a mask of the lowest bits of a word.
+             *
+             * @param count the number of the lowest bits to be set.
+             * @return the mask.
+             */
+            static uint32 getMask(int32 count);
+            
+            /**
+             * Returns a number of the lowest set bit of a word.
+             *
+             * @param word a non-zero word.
+             * @return the bit number.
+             */
+            static int32 getLowestBit(uint32 word);
+            
+            /**
+             * The flag of used chunks in the size field.
+             */
+            static const size_t USED = 1;
+            
+            /**
+             * The flag of direct blocks in the size field.
+             */
+            static const size_t DIRECT = 2;
+            
+            /**
+             * The alignment of chunks in bytes.
+             */
+            static const size_t ALIGNMENT = 8;
+            
+            /**
+             * The size of an arena header followed by the first chunk in bytes.
+             */
+            static const size_t ARENA_HEADER = (sizeof(Arena) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+            
+            /**
+             * The size of arenas in bytes.
+             */
+            static const size_t ARENA_SIZE = SYSTEM_ALLOCATOR_ARENA_SIZE;
+            
+            /**
+             * The biggest chunk size of the arenas in bytes, and the granularity of direct blocks.
+             */
+            static const size_t DIRECT_SIZE = ARENA_SIZE / 8;
+            
+            /**
+             * The chunks of sizes less than 2^EXACT_BITS bytes are binned by their exact sizes.
+             */
+            static const int32 EXACT_BITS = 9;
+            
+            /**
+             * The number of bins of chunks of exact sizes.
+             */
+            static const int32 EXACT_BINS = (1 << EXACT_BITS) / static_cast<int32>(ALIGNMENT);
+            
+            /**
+             * The number of bins each power of two bigger sizes is divided into, as a power of two.
+             */
+            static const int32 SPLIT_BITS = 2;
+            
+            /**
+             * The number of bins of free chunks.
+             */
+            static const int32 BINS_NUMBER = EXACT_BINS + ((32 - EXACT_BITS) << SPLIT_BITS);
+            
+            /**
+             * The number of bits in a word of the bins bitmap.
+             */
+            static const int32 WORD_BITS = 32;
+            
+            /**
+             * The number of words of the bins bitmap.
+             */
+            static const int32 WORDS_NUMBER = (BINS_NUMBER + WORD_BITS - 1) / WORD_BITS;
+            
+            /**
+             * The arenas.
+             */
+            static Arena* arenas_;
+            
+            /**
+             * The number of empty arenas.
+             */
+            static uint32 empty_;
+            
+            /**
+             * The free chunks lists of the bins.
+             */
+            static FreeChunk* bins_[BINS_NUMBER];
+            
+            /**
+             * The bitmap of bins, which have free chunks.
+             */
+            static uint32 map_[WORDS_NUMBER];
     
         };
     }
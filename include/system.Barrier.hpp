@@ -0,0 +1,122 @@
+/** 
+ * Reusable barrier of threads.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_BARRIER_HPP_
+#define SYSTEM_BARRIER_HPP_
+
+#include "system.Object.hpp"
+#include "system.Semaphore.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class Barrier : public system::Object
+        {
+            typedef system::Barrier Self;
+            typedef system::Object  Parent;
+        
+        public:
+        
+            /** 
+             * Constructor.
+             *
+             * @param parties the number of threads, which must arrive to pass the barrier.
+             */
+            Barrier(int32 parties);
+            
+            /** 
+             * Destructor.
+             */
+            virtual ~Barrier();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Waits until all parties arrive.
+             *
+             * The last arriving thread does not wait, and releases one permit for each waiting 
+             * thread out of critical sections. The barrier is reused for the next phase 
+             * as soon as the last thread arrives.
+             *
+             * @return true for the last arriving thread, and false for other threads.
+             */
+            bool await();
+            
+            /**
+             * Arrives at the barrier without waiting for other parties.
+             *
+             * The function arrives for a party, which does not take part in the current phase. 
+             * The calling thread must not arrive for the same party again until the phase is passed.
+             *
+             * @return true for the last arriving thread, and false for other threads.
+             */
+            bool arrive();
+            
+        private:
+        
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct();
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Barrier(const Barrier& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            Barrier& operator =(const Barrier& obj);
+            
+            /**
+             * The number of threads, which must arrive to pass the barrier.
+             */
+            int32 parties_;
+            
+            /**
+             * The number of threads, which have to arrive in the current phase.
+             */
+            int32 count_;
+            
+            /**
+             * The current phase.
+             */
+            uint32 phase_;
+            
+            /**
+             * The numbers of threads waiting at the gates of even and odd phases.
+             */
+            int32 waiting_[2];
+            
+            /**
+             * The gate semaphore of even phases.
+             */
+            Semaphore gate0_;
+            
+            /**
+             * The gate semaphore of odd phases.
+             */
+            Semaphore gate1_;
+        
+        };
+    }
+}
+#endif // SYSTEM_BARRIER_HPP_
@@ -0,0 +1,106 @@
+/** 
+ * Boot time trace.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_BOOT_TRACE_HPP_
+#define SYSTEM_BOOT_TRACE_HPP_
+
+#include "Types.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class BootTrace
+        {
+        
+        public:
+        
+            /**
+             * A milestone of the boot.
+             */
+            struct Milestone
+            {
+                /**
+                 * The milestone name.
+                 */
+                const char* name;
+                
+                /**
+                 * The time of reaching the milestone in nanoseconds.
+                 */
+                int64 time;
+            };
+            
+            /**
+             * The maximum number of milestones.
+             */
+            static const int32 MILESTONES_NUMBER = 32;
+            
+            /**
+             * Marks a milestone.
+             *
+             * The milestones are recorded if the SYSTEM_BOOT_TRACE macro is defined.
+             * The system subsystems mark their constructions, and a program might 
+             * mark its own milestones until the trace is full.
+             *
+             * @param name a constant string of the milestone name.
+             */
+            static void mark(const char* name)
+            {
+                #ifdef SYSTEM_BOOT_TRACE
+                record(name);
+                #else
+                static_cast<void>(name);
+                #endif
+            }
+            
+            /**
+             * Returns the number of marked milestones.
+             *
+             * @return the number of milestones.
+             */
+            static int32 getLength();
+            
+            /**
+             * Returns a marked milestone.
+             *
+             * @param index     an index of the milestone in marking order.
+             * @param milestone a milestone for copying to.
+             * @return true if the milestone has been copied.
+             */
+            static bool get(int32 index, Milestone& milestone);
+            
+        private:
+        
+            #ifdef SYSTEM_BOOT_TRACE
+            /**
+             * Records a milestone.
+             *
+             * @param name a constant string of the milestone name.
+             */
+            static void record(const char* name);
+            
+            /**
+             * The marked milestones.
+             */
+            static Milestone milestones_[MILESTONES_NUMBER];
+            
+            /**
+             * The number of marked milestones.
+             */
+            static int32 length_;
+            #endif // SYSTEM_BOOT_TRACE
+            
+            /**
+             * Constructor.
+             */
+            BootTrace();
+        
+        };
+    }
+}
+#endif // SYSTEM_BOOT_TRACE_HPP_
@@ -0,0 +1,266 @@
+/** 
+ * Pool of fixed-size buffers with reference-counted descriptors.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_BUFFER_POOL_HPP_
+#define SYSTEM_BUFFER_POOL_HPP_
+
+#include "system.Object.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class BufferPool : public system::Object
+        {
+            typedef system::BufferPool Self;
+            typedef system::Object     Parent;
+            
+            struct Block;
+        
+        public:
+        
+            /**
+             * Descriptor of a memory region of a pool block.
+             *
+             * Descriptors of one block share the block memory, and the block 
+             * is returned to the pool when the last of its descriptors is released.
+             */
+            class Buffer
+            {
+                friend class system::BufferPool;
+            
+            public:
+            
+                /**
+                 * Returns the region address.
+                 *
+                 * @return the first byte of the region.
+                 */
+                uint8* getData() const
+                {
+                    return data_;
+                }
+                
+                /**
+                 * Returns the region length.
+                 *
+                 * @return the number of bytes of the region.
+                 */
+                int32 getLength() const
+                {
+                    return length_;
+                }
+                
+            private:
+            
+                /**
+                 * The region address.
+                 */
+                uint8* data_;
+                
+                /**
+                 * The region length in bytes.
+                 */
+                int32 length_;
+                
+                /**
+                 * The block of the region.
+                 */
+                Block* block_;
+                
+                /**
+                 * The next free descriptor.
+                 */
+                Buffer* next_;
+            
+            };
+        
+            /** 
+             * Constructor.
+             *
+             * The memory of the pool is allocated once here.
+             *
+             * @param size        the size of a block in bytes.
+             * @param number      the number of blocks.
+             * @param descriptors the number of descriptors, which is not less than the number of blocks.
+             */
+            BufferPool(int32 size, int32 number, int32 descriptors);
+            
+            /** 
+             * Destructor.
+             */
+            virtual ~BufferPool();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Takes a free block.
+             *
+             * The function might be called by an interrupt handler.
+             *
+             * @return a descriptor of the whole block, or NULL if no block or descriptor is free.
+             */
+            Buffer* allocate();
+            
+            /**
+             * Creates a descriptor of a region of a buffer without copying.
+             *
+             * The function might be called by an interrupt handler.
+             *
+             * @param buffer a descriptor of this pool.
+             * @param offset the region offset from the buffer data.
+             * @param length the region length.
+             * @return a new descriptor of the region, or NULL if an error has been occurred,
+             *         or the buffer is released or is not a descriptor of this pool.
+             */
+            Buffer* slice(const Buffer& buffer, int32 offset, int32 length);
+            
+            /**
+             * Creates a descriptor of a buffer without copying.
+             *
+             * The function might be called by an interrupt handler.
+             *
+             * @param buffer a descriptor of this pool.
+             * @return a new descriptor of the same region, or NULL if no descriptor is free.
+             */
+            Buffer* share(const Buffer& buffer);
+            
+            /**
+             * Releases a descriptor, and returns its block to the pool if it is not referenced anymore.
+             *
+             * The function might be called by an interrupt handler.
+             *
+             * @param buffer a descriptor of this pool, or NULL.
+             */
+            void release(Buffer* buffer);
+            
+            /**
+             * Returns the size of a block.
+             *
+             * @return the block size in bytes.
+             */
+            int32 getSize() const;
+            
+            /**
+             * Returns the number of free blocks.
+             *
+             * @return the number of blocks which might be allocated.
+             */
+            int32 getFree() const;
+            
+        private:
+        
+            /**
+             * Block of the pool memory.
+             */
+            struct Block
+            {
+                /**
+                 * The block memory.
+                 */
+                uint8* data;
+                
+                /**
+                 * The number of descriptors of the block.
+                 */
+                int32 references;
+                
+                /**
+                 * The next free block.
+                 */
+                Block* next;
+            };
+            
+            /**
+             * Tests if a descriptor belongs to this pool.
+             *
+             * @param buffer a descriptor.
+             * @return true if the descriptor is one of this pool.
+             */
+            bool isOwn(const Buffer* buffer) const;
+        
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct();
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            BufferPool(const BufferPool& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            BufferPool& operator =(const BufferPool& obj);
+            
+            /**
+             * The alignment of blocks in bytes.
+             */
+            static const int32 ALIGNMENT = 8;
+            
+            /**
+             * The size of a block in bytes.
+             */
+            int32 size_;
+            
+            /**
+             * The number of blocks.
+             */
+            int32 number_;
+            
+            /**
+             * The number of descriptors.
+             */
+            int32 descriptors_;
+            
+            /**
+             * The number of free blocks.
+             */
+            int32 free_;
+            
+            /**
+             * The memory of blocks.
+             */
+            uint8* memory_;
+            
+            /**
+             * The blocks.
+             */
+            Block* blocks_;
+            
+            /**
+             * The descriptors.
+             */
+            Buffer* buffers_;
+            
+            /**
+             * The free blocks.
+             */
+            Block* freeBlocks_;
+            
+            /**
+             * The free descriptors.
+             */
+            Buffer* freeBuffers_;
+        
+        };
+    }
+}
+#endif // SYSTEM_BUFFER_POOL_HPP_
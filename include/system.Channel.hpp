@@ -0,0 +1,207 @@
+/** 
+ * Shared memory channel of messages between modules.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_CHANNEL_HPP_
+#define SYSTEM_CHANNEL_HPP_
+
+#include "system.Object.hpp"
+#include "system.Semaphore.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class Channel : public system::Object
+        {
+            typedef system::Channel Self;
+            typedef system::Object  Parent;
+        
+        public:
+        
+            /**
+             * The maximum length of a channel name.
+             */
+            static const int32 NAME_LENGTH = 24;
+        
+            /** 
+             * Constructor.
+             *
+             * The writing and the reading modules construct the channel with the same name and size. 
+             * The messages are copied to a ring buffer in a shared memory region, and 
+             * the semaphores of the channel are released only if the other side is waiting.
+             * The channel is built if the SYSTEM_CHANNEL macro is defined, as it needs
+             * the shared memory calls of the porting OS.
+             *
+             * @param name the channel name.
+             * @param size the ring buffer size in bytes, which is a power of two.
+             */
+            Channel(const char* name, int32 size);
+            
+            /** 
+             * Destructor.
+             */
+            virtual ~Channel();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Writes a message, and waits for free space if the ring buffer is full.
+             *
+             * The channel has one writing thread.
+             *
+             * @param data   the message.
+             * @param length the message length in bytes.
+             * @return true if the message has been written.
+             */
+            bool write(const void* data, int32 length);
+            
+            /**
+             * Reads a message, and waits for it if the ring buffer is empty.
+             *
+             * The channel has one reading thread. A message which does not fit 
+             * the buffer is dropped, and the next message is read by the next call.
+             *
+             * @param data the buffer for the message.
+             * @param size the buffer size in bytes.
+             * @return the message length, or -1 if an error has been occurred or the message has been dropped.
+             */
+            int32 read(void* data, int32 size);
+            
+        private:
+        
+            /**
+             * Header of the shared memory region.
+             *
+             * The counters of bytes run over the ring buffer size, and a new region of zeros is an empty channel.
+             */
+            struct Header
+            {
+                /**
+                 * The number of bytes written.
+                 */
+                volatile uint32 head;
+                
+                /**
+                 * The number of bytes read.
+                 */
+                volatile uint32 tail;
+                
+                /**
+                 * The reader is waiting for a message.
+                 */
+                volatile uint32 isReading;
+                
+                /**
+                 * The writer is waiting for free space.
+                 */
+                volatile uint32 isWriting;
+                
+                /**
+                 * The number of modules which have opened the channel.
+                 */
+                volatile uint32 sides;
+            };
+        
+            /**
+             * Constructor.
+             *
+             * @param name the channel name.
+             * @return true if object has been constructed successfully.
+             */
+            bool construct(const char* name);
+            
+            /**
+             * Copies bytes to the ring buffer.
+             *
+             * @param index  the ring buffer index.
+             * @param data   the bytes.
+             * @param length the number of bytes.
+             */
+            void copyTo(uint32 index, const uint8* data, int32 length);
+            
+            /**
+             * Copies bytes from the ring buffer.
+             *
+             * @param index  the ring buffer index.
+             * @param data   the buffer for the bytes.
+             * @param length the number of bytes.
+             */
+            void copyFrom(uint32 index, uint8* data, int32 length) const;
+            
+            /**
+             * Orders the memory accesses of the modules.
+             */
+            static void fence();
+            
+            /**
+             * Adds a value to a shared counter.
+             *
+             * @param counter the counter.
+             * @param value   the value.
+             * @return the counter value before the adding.
+             */
+            static uint32 add(volatile uint32* counter, int32 value);
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Channel(const Channel& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            Channel& operator =(const Channel& obj);
+            
+            /**
+             * The alignment of messages in bytes.
+             */
+            static const int32 ALIGNMENT = 4;
+            
+            /**
+             * The ring buffer size in bytes.
+             */
+            int32 size_;
+            
+            /**
+             * The porting OS resource of the shared memory region.
+             */
+            uint32 res_;
+            
+            /**
+             * The header of the shared memory region.
+             */
+            Header* header_;
+            
+            /**
+             * The ring buffer following the header.
+             */
+            uint8* ring_;
+            
+            /**
+             * The semaphore the reader waits for a message on.
+             */
+            Semaphore* readable_;
+            
+            /**
+             * The semaphore the writer waits for free space on.
+             */
+            Semaphore* writable_;
+        
+        };
+    }
+}
+#endif // SYSTEM_CHANNEL_HPP_
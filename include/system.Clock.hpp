@@ -0,0 +1,109 @@
+/** 
+ * Monotonic clock of the operating system.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_CLOCK_HPP_
+#define SYSTEM_CLOCK_HPP_
+
+#include "os.h"
+#include "Types.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class Clock
+        {
+        
+        public:
+        
+            /**
+             * Returns the monotonic time.
+             *
+             * The time is counted from an undefined moment of the system start,
+             * it never decreases, and it is the time of System::getTime.
+             *
+             * @return time in nanoseconds.
+             */
+            static int64 getTime()
+            {
+                return static_cast<int64>( time_core_n() );
+            }
+            
+            /**
+             * Returns the value of the fastest counter of the processor.
+             *
+             * The counter is the time stamp counter on x86 processors, 
+             * and the monotonic time in nanoseconds on other processors.
+             * The counter frequency might differ from the processor frequency, 
+             * and the values are comparable only on one processor.
+             *
+             * @return counter value.
+             */
+            static uint64 getCounter()
+            {
+                #if defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+                uint32 low;
+                uint32 high;
+                __asm__ __volatile__ ("rdtsc" : "=a" (low), "=d" (high));
+                return static_cast<uint64>(high) << 32 | static_cast<uint64>(low);
+                #else
+                return time_core_n();
+                #endif
+            }
+            
+            /**
+             * Converts a number of counter ticks to nanoseconds.
+             *
+             * @param ticks a number of counter ticks.
+             * @return time in nanoseconds.
+             */
+            static int64 toNanos(uint64 const ticks)
+            {
+                // The scale is the 32.32 fixed point number of nanoseconds per tick
+                uint64 const high = ticks >> 32;
+                uint64 const low = ticks & 0xFFFFFFFFu;
+                return static_cast<int64>( high * scale_ + ( low * scale_ >> 32 ) );
+            }
+            
+            /**
+             * Returns the counter frequency.
+             *
+             * @return the number of counter ticks per second.
+             */
+            static int64 getFrequency();
+            
+            /**
+             * Calibrates the counter by the monotonic time.
+             *
+             * The function busy-waits for CALIBRATION_TIME nanoseconds
+             * if the counter is not the monotonic time itself.
+             *
+             * @return true if the counter has been calibrated.
+             */
+            static bool calibrate();
+            
+            /**
+             * The calibration time in nanoseconds.
+             */
+            static const int64 CALIBRATION_TIME = 1000000;
+            
+        private:
+        
+            /**
+             * Constructor.
+             */
+            Clock();
+            
+            /**
+             * The number of nanoseconds per counter tick in 32.32 fixed point format.
+             */
+            static uint64 scale_;
+        
+        };
+    }
+}
+#endif // SYSTEM_CLOCK_HPP_
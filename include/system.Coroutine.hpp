@@ -0,0 +1,253 @@
+/** 
+ * Stackless coroutine.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_COROUTINE_HPP_
+#define SYSTEM_COROUTINE_HPP_
+
+#include "system.Object.hpp"
+#include "system.Clock.hpp"
+
+/**
+ * Begins a body of the resume function.
+ */
+#define COROUTINE_BEGIN() switch(line_) { case 0:
+
+/**
+ * Ends a body of the resume function.
+ */
+#define COROUTINE_END() default: break; } line_ = -1; return DONE
+
+/**
+ * Suspends a coroutine until the next resumption.
+ */
+#define COROUTINE_YIELD() do { line_ = __LINE__; return YIELDED; case __LINE__: ; } while(false)
+
+/**
+ * Suspends a coroutine until a condition is true.
+ *
+ * The scheduler must be notified by the code which makes the condition true.
+ *
+ * @param condition an expression evaluated on each resumption.
+ */
+#define COROUTINE_WAIT_UNTIL(condition) do { line_ = __LINE__; case __LINE__: if( not (condition) ) return WAITING; } while(false)
+
+/**
+ * Suspends a coroutine for a time.
+ *
+ * @param millis a time in milliseconds.
+ */
+#define COROUTINE_SLEEP(millis) do { wake_ = ::local::system::Clock::getTime() + static_cast<int64>(millis) * 1000000; COROUTINE_WAIT_UNTIL(::local::system::Clock::getTime() >= wake_); } while(false)
+
+/**
+ * Suspends a coroutine until a permit of a system semaphore is acquired.
+ *
+ * @param semaphore a system::Semaphore object.
+ */
+#define COROUTINE_ACQUIRE(semaphore) COROUTINE_WAIT_UNTIL( take( (semaphore), &::local::system::Semaphore::tryAcquire ) )
+
+/**
+ * Suspends a coroutine until a system mutex is locked.
+ *
+ * @param mutex a system::Mutex object.
+ */
+#define COROUTINE_LOCK(mutex) COROUTINE_WAIT_UNTIL( take( (mutex), &::local::system::Mutex::tryLock ) )
+
+namespace local
+{
+    namespace system
+    {
+        class CoroutineScheduler;
+    
+        class Coroutine : public system::Object
+        {
+            typedef system::Coroutine Self;
+            typedef system::Object    Parent;
+            
+            friend class system::CoroutineScheduler;
+        
+        public:
+        
+            /**
+             * Statuses of a resumption.
+             */
+            enum Status
+            {
+                /**
+                 * The coroutine has yielded after doing some work.
+                 */
+                YIELDED = 0,
+                
+                /**
+                 * The coroutine is waiting for an event.
+                 */
+                WAITING = 1,
+                
+                /**
+                 * The coroutine has completed.
+                 */
+                DONE = 2
+            };
+        
+            /** 
+             * Constructor.
+             */
+            Coroutine() : Parent(),
+                line_      (0),
+                wake_      (0),
+                isDone_    (false),
+                waiting_   (NULL),
+                scheduler_ (NULL),
+                next_      (NULL){
+            }
+            
+            /** 
+             * Destructor.
+             *
+             * The coroutine is removed from its scheduler. As the carrier thread might 
+             * resume the coroutine until then, a derived class, which is destroyed while 
+             * the coroutine has not completed, calls the remove function in its destructor.
+             */
+            virtual ~Coroutine();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const
+            {
+                return Parent::isConstructed();
+            }
+            
+            /**
+             * Resumes the coroutine from the point it has been suspended at.
+             *
+             * The function body is enclosed by COROUTINE_BEGIN and COROUTINE_END, 
+             * and it is suspended by the other COROUTINE macros. The coroutine 
+             * has no stack of its own, therefore local variables are lost on 
+             * suspensions, and a state must be kept in class members. The suspension
+             * points are identified by source lines, so one line must not contain 
+             * two suspension points.
+             *
+             * @return the resumption status.
+             */
+            virtual Status resume() = 0;
+            
+            /**
+             * Tests if the coroutine has completed.
+             *
+             * @return true if the coroutine has been completed.
+             */
+            bool isDone() const
+            {
+                return isDone_;
+            }
+            
+            /**
+             * Removes the coroutine from its scheduler.
+             *
+             * The function waits for the end of the resumption pass of the scheduler, 
+             * so it must not be called by a coroutine of the same scheduler. The coroutine 
+             * which has not completed is not resumed anymore, and might be added again.
+             */
+            void remove();
+            
+            /**
+             * Wakes the idle coroutine schedulers up.
+             *
+             * The function is called by system semaphores and mutexes which are 
+             * released while coroutines are waiting for them.
+             */
+            static void notifyAll();
+            
+        protected:
+        
+            /**
+             * Takes a system semaphore or mutex without waiting.
+             *
+             * The coroutine which fails to take the primitive is counted as waiting for it 
+             * until the coroutine takes it, so the primitive notifies the schedulers on releasing.
+             *
+             * @param primitive a system::Semaphore or system::Mutex object.
+             * @param tryTake   the function of taking the primitive during a timeout.
+             * @return true if the primitive has been taken.
+             */
+            template <class T>
+            bool take(T& primitive, bool (T::*tryTake)(int64))
+            {
+                if(waiting_ == NULL)
+                {
+                    if( (primitive.*tryTake)(0) ) return true;
+                    // The primitive is tried again, as it might have been released before the counting
+                    waiting_ = &primitive.coroutines_;
+                    count(*waiting_, 1);
+                }
+                if( not (primitive.*tryTake)(0) ) return false;
+                count(*waiting_, -1);
+                waiting_ = NULL;
+                return true;
+            }
+        
+            /**
+             * The source line of the suspension point.
+             */
+            int32 line_;
+            
+            /**
+             * The time of waking up from a sleep in nanoseconds.
+             */
+            int64 wake_;
+            
+        private:
+        
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Coroutine(const Coroutine& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            Coroutine& operator =(const Coroutine& obj);
+            
+            /**
+             * Changes the number of coroutines waiting for a primitive.
+             *
+             * @param coroutines the number of coroutines waiting for a primitive.
+             * @param number     one for a coroutine starting waiting, or minus one for a coroutine ending.
+             */
+            static void count(volatile int32& coroutines, int32 number);
+            
+            /**
+             * The coroutine has completed.
+             */
+            volatile bool isDone_;
+            
+            /**
+             * The number of coroutines waiting for the primitive the coroutine is waiting for.
+             */
+            volatile int32* waiting_;
+            
+            /**
+             * The scheduler the coroutine has been added to.
+             */
+            CoroutineScheduler* scheduler_;
+            
+            /**
+             * The next coroutine of a scheduler list.
+             */
+            Coroutine* next_;
+        
+        };
+    }
+}
+#endif // SYSTEM_COROUTINE_HPP_
@@ -0,0 +1,202 @@
+/** 
+ * Scheduler of stackless coroutines.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_COROUTINE_SCHEDULER_HPP_
+#define SYSTEM_COROUTINE_SCHEDULER_HPP_
+
+#include "os.h"
+#include "system.Object.hpp"
+#include "api.Task.hpp"
+#include "api.Scheduler.hpp"
+#include "system.Coroutine.hpp"
+#include "system.Mutex.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class CoroutineScheduler : public system::Object, public api::Task
+        {
+            typedef system::CoroutineScheduler Self;
+            typedef system::Object             Parent;
+            
+            friend class system::Coroutine;
+        
+        public:
+            
+            /** 
+             * Constructor.
+             *
+             * @param scheduler the scheduler which creates a carrier thread.
+             */     
+            CoroutineScheduler(api::Scheduler& scheduler);
+            
+            /** 
+             * Destructor.
+             *
+             * The coroutines which have not completed are not resumed anymore.
+             */
+            virtual ~CoroutineScheduler();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Resumes the coroutines in the carrier thread.
+             *
+             * @return zero, or error code if an error has been occurred.
+             */        
+            virtual int32 start();
+            
+            /**
+             * Returns size of stack.
+             *
+             * @return stack size in bytes.
+             */
+            virtual int32 getStackSize() const;
+            
+            /**
+             * Adds a coroutine for resuming.
+             *
+             * @param coroutine a coroutine which has not been added to any scheduler.
+             * @return true if the coroutine has been added successfully.
+             */
+            bool add(Coroutine& coroutine);
+            
+            /**
+             * Wakes the carrier thread up if all coroutines are waiting.
+             *
+             * The function might be called by a thread or an interrupt handler, 
+             * which has produced an event some coroutine is waiting for. The system 
+             * semaphores and mutexes, which coroutines are waiting for, wake the carrier 
+             * threads up themselves.
+             */
+            void notify();
+            
+        private:
+        
+            /**
+             * Removes a coroutine from the resumption lists.
+             *
+             * @param coroutine a coroutine which has been added to the scheduler.
+             */
+            void remove(Coroutine& coroutine);
+            
+            /**
+             * Detaches the coroutines of a list from the scheduler.
+             *
+             * @param coroutines the first coroutine of the list.
+             */
+            void detach(Coroutine*& coroutines);
+        
+            /**
+             * Suspends the carrier thread until an event or a timeout.
+             *
+             * @param events the number of events before the resumption of the coroutines.
+             * @param millis a timeout in milliseconds, or zero for waiting without a timeout.
+             */
+            void idle(uint32 events, int64 millis);
+            
+            /**
+             * Wakes the carrier thread up if it is idle.
+             *
+             * The function is called in a critical section.
+             */
+            void wake();
+        
+            /**
+             * Constructor.
+             *
+             * @param scheduler the scheduler which creates a carrier thread.
+             * @return true if object has been constructed successfully.
+             */
+            bool construct(api::Scheduler& scheduler);
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            CoroutineScheduler(const CoroutineScheduler& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            CoroutineScheduler& operator =(const CoroutineScheduler& obj);
+            
+            /**
+             * The carrier thread stack size in bytes.
+             */
+            static const int32 STACK_SIZE = 0x1000;
+            
+            /**
+             * The coroutines being resumed.
+             */
+            Coroutine* coroutines_;
+            
+            /**
+             * The added coroutines which have not been resumed yet.
+             */
+            Coroutine* added_;
+            
+            /**
+             * The mutex held by the carrier thread while it resumes the coroutines.
+             */
+            Mutex mutex_;
+            
+            /**
+             * The scheduler is being destroyed.
+             */
+            volatile bool isStopping_;
+            
+            /**
+             * The porting OS semaphore of notifications, which is not a system 
+             * semaphore, as releasing system semaphores notifies the schedulers.
+             */
+            uint32 res_;
+            
+            /**
+             * The carrier thread.
+             */
+            api::Thread* thread_;
+            
+            /**
+             * The carrier thread is idle.
+             */
+            bool isIdle_;
+            
+            /**
+             * The next idle scheduler.
+             */
+            CoroutineScheduler* nextIdle_;
+            
+            /**
+             * The number of constructed schedulers.
+             */
+            static int32 schedulers_;
+            
+            /**
+             * The number of events, which is changed by each notification.
+             */
+            static volatile uint32 events_;
+            
+            /**
+             * The idle schedulers.
+             */
+            static CoroutineScheduler* idle_;
+        
+        };
+    }
+}
+#endif // SYSTEM_COROUTINE_SCHEDULER_HPP_
@@ -0,0 +1,207 @@
+/** 
+ * Critical section guard.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_CRITICAL_SECTION_HPP_
+#define SYSTEM_CRITICAL_SECTION_HPP_
+
+#include "os.h"
+#include "Types.hpp"
+#include "system.Interrupt.hpp"
+#include "system.GlobalThread.hpp"
+#include "system.Clock.hpp"
+
+/**
+ * Initializes a call site of critical sections.
+ *
+ * @param name the site name.
+ */
+#define CRITICAL_SECTION_SITE(name) { name, 0, 0, 0, 0, false, NULL }
+
+namespace local
+{
+    namespace system
+    {
+        class CriticalSection
+        {
+        
+        public:
+        
+            /**
+             * Types of critical sections.
+             */
+            enum Type
+            {
+                /**
+                 * All maskable interrupts are disabled.
+                 */
+                INTERRUPTS = 0,
+                
+                /**
+                 * Global thread switching is disabled.
+                 */
+                THREADS = 1
+            };
+            
+            /**
+             * A call site of critical sections.
+             *
+             * A site is declared as a static object initialized by the 
+             * CRITICAL_SECTION_SITE macro with its name. Its statistics are collected if the SYSTEM_CRITICAL_STATISTICS 
+             * macro is defined, and the site is linked to the sites list on the first exit 
+             * of its critical section. Only the outermost critical section of nested 
+             * sections of one type is measured.
+             */
+            struct Site
+            {
+                /**
+                 * The site name.
+                 */
+                const char* name;
+                
+                /**
+                 * The number of measured critical sections.
+                 */
+                uint32 count;
+                
+                /**
+                 * The longest duration of the critical sections in nanoseconds.
+                 */
+                int64 max;
+                
+                /**
+                 * The total duration of the critical sections in nanoseconds.
+                 */
+                int64 total;
+                
+                /**
+                 * The type of the longest critical section.
+                 */
+                int32 type;
+                
+                /**
+                 * The site is linked to the sites list.
+                 */
+                bool isLinked;
+                
+                /**
+                 * The next site of the sites list.
+                 */
+                Site* next;
+            };
+        
+            /** 
+             * Constructor.
+             *
+             * Enters a critical section.
+             *
+             * @param site a call site of the critical section.
+             * @param type a type of the critical section.
+             */
+            CriticalSection(Site& site, Type type = INTERRUPTS) :
+                site_   (site),
+                type_   (type),
+                status_ (false),
+                time_   (0){
+                status_ = type_ == INTERRUPTS ? Interrupt::disableAll() : GlobalThread::disableAll();
+                #ifdef SYSTEM_CRITICAL_STATISTICS
+                if(status_)
+                {
+                    time_ = Clock::getTime();
+                }
+                #endif
+            }
+            
+            /** 
+             * Destructor.
+             *
+             * Leaves the critical section.
+             */
+            ~CriticalSection()
+            {
+                #ifdef SYSTEM_CRITICAL_STATISTICS
+                if(status_)
+                {
+                    record(site_, type_, Clock::getTime() - time_);
+                }
+                #endif
+                if(type_ == INTERRUPTS)
+                {
+                    Interrupt::enableAll(status_);
+                }
+                else
+                {
+                    GlobalThread::enableAll(status_);
+                }
+            }
+            
+            /**
+             * Returns the first site of the sites list.
+             *
+             * @return the site, or NULL if no site has been measured.
+             */
+            static const Site* getSites();
+            
+            /**
+             * Resets statistics of all sites.
+             */
+            static void reset();
+            
+        private:
+        
+            /**
+             * Records a critical section to the site statistics.
+             *
+             * @param site     a call site of the critical section.
+             * @param type     a type of the critical section.
+             * @param duration the critical section duration in nanoseconds.
+             */
+            static void record(Site& site, Type type, int64 duration);
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            CriticalSection(const CriticalSection& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            CriticalSection& operator =(const CriticalSection& obj);
+            
+            /**
+             * The sites list.
+             */
+            static Site* sites_;
+            
+            /**
+             * The call site of this critical section.
+             */
+            Site& site_;
+            
+            /**
+             * The type of this critical section.
+             */
+            Type type_;
+            
+            /**
+             * The status returned by the disable function.
+             */
+            bool status_;
+            
+            /**
+             * The time of entering this critical section.
+             */
+            int64 time_;
+        
+        };
+    }
+}
+#endif // SYSTEM_CRITICAL_SECTION_HPP_
@@ -0,0 +1,203 @@
+/** 
+ * Group of event flags.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_EVENT_GROUP_HPP_
+#define SYSTEM_EVENT_GROUP_HPP_
+
+#include "system.Object.hpp"
+#include "system.Semaphore.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class EventGroup : public system::Object
+        {
+            typedef system::EventGroup Self;
+            typedef system::Object     Parent;
+        
+        public:
+        
+            /** 
+             * Constructor.
+             *
+             * @param flags the initial value of the flags.
+             */
+            EventGroup(uint32 flags);
+            
+            /** 
+             * Destructor.
+             */
+            virtual ~EventGroup();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Sets flags, and wakes the waiting threads up.
+             *
+             * The function might be called by an interrupt handler.
+             *
+             * @param mask the flags to set.
+             * @return the flags after setting.
+             */
+            uint32 set(uint32 mask);
+            
+            /**
+             * Clears flags.
+             *
+             * @param mask the flags to clear.
+             * @return the flags before clearing.
+             */
+            uint32 clear(uint32 mask);
+            
+            /**
+             * Returns the flags.
+             *
+             * @return the current flags.
+             */
+            uint32 get() const;
+            
+            /**
+             * Waits for flags.
+             *
+             * @param mask    the flags to wait for.
+             * @param isAll   true for waiting for all the flags, or false for any of them.
+             * @param isClear true for clearing the flags of the mask on successful waiting.
+             * @return the flags of the mask, which have been set, or zero if an error has been occurred.
+             */
+            uint32 wait(uint32 mask, bool isAll, bool isClear);
+            
+            /**
+             * Waits for flags during a timeout.
+             *
+             * @param mask    the flags to wait for.
+             * @param isAll   true for waiting for all the flags, or false for any of them.
+             * @param isClear true for clearing the flags of the mask on successful waiting.
+             * @param millis  a timeout in milliseconds, or zero for a try without waiting.
+             * @return the flags of the mask, which have been set, or zero if the timeout has expired.
+             */
+            uint32 wait(uint32 mask, bool isAll, bool isClear, int64 millis);
+            
+        private:
+        
+            /**
+             * A thread waiting for flags.
+             */
+            struct Waiter
+            {
+                /**
+                 * The flags to wait for.
+                 */
+                uint32 mask;
+                
+                /**
+                 * The thread waits for all the flags.
+                 */
+                bool isAll;
+                
+                /**
+                 * The flags are cleared on successful waiting.
+                 */
+                bool isClear;
+                
+                /**
+                 * The flags of the mask, which have woken the thread up.
+                 */
+                uint32 flags;
+                
+                /**
+                 * The semaphore the thread waits on, which is reused by next waitings.
+                 */
+                Semaphore* sem;
+                
+                /**
+                 * The next waiting thread, or the next free waiter.
+                 */
+                Waiter* next;
+            };
+            
+            /**
+             * Takes a free waiter, or creates a new one.
+             *
+             * @return a waiter, or NULL if an error has been occurred.
+             */
+            Waiter* takeWaiter();
+            
+            /**
+             * Puts a waiter, which has no permit of its semaphore, to the free waiters.
+             *
+             * @param waiter a waiter taken by the takeWaiter function.
+             */
+            void putWaiter(Waiter* waiter);
+            
+            /**
+             * Tests if flags satisfy a waiting.
+             *
+             * @param flags   the flags.
+             * @param mask    the flags to wait for.
+             * @param isAll   true for waiting for all the flags, or false for any of them.
+             * @return the flags of the mask, which satisfy the waiting, or zero.
+             */
+            static uint32 match(uint32 flags, uint32 mask, bool isAll);
+        
+            /**
+             * Waits for flags during a timeout.
+             *
+             * @param mask    the flags to wait for.
+             * @param isAll   true for waiting for all the flags, or false for any of them.
+             * @param isClear true for clearing the flags of the mask on successful waiting.
+             * @param millis  a timeout in milliseconds, or a negative value for infinite waiting.
+             * @return the flags of the mask, which have been set, or zero if the timeout has expired.
+             */
+            uint32 waitFlags(uint32 mask, bool isAll, bool isClear, int64 millis);
+            
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct();
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            EventGroup(const EventGroup& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            EventGroup& operator =(const EventGroup& obj);
+            
+            /**
+             * The flags.
+             */
+            volatile uint32 flags_;
+            
+            /**
+             * The waiting threads in order of their waiting.
+             */
+            Waiter* waiters_;
+            
+            /**
+             * The free waiters, whose semaphores are not allocated for each waiting.
+             */
+            Waiter* free_;
+        
+        };
+    }
+}
+#endif // SYSTEM_EVENT_GROUP_HPP_
@@ -0,0 +1,199 @@
+/** 
+ * Result of a task executed asynchronously.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_FUTURE_HPP_
+#define SYSTEM_FUTURE_HPP_
+
+#include "system.Object.hpp"
+#include "api.Task.hpp"
+#include "api.Scheduler.hpp"
+#include "system.Latch.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class Future : public system::Object, public api::Task
+        {
+            typedef system::Future Self;
+            typedef system::Object Parent;
+        
+        public:
+        
+            /** 
+             * Constructor.
+             *
+             * The task is started in a new thread at once.
+             *
+             * @param scheduler the scheduler which creates a thread of the task.
+             * @param task      a user task.
+             */
+            Future(api::Scheduler& scheduler, api::Task& task);
+            
+            /** 
+             * Destructor.
+             *
+             * The destructor waits for the completion of the started task. 
+             * A continuation which has not been started yet is never started, 
+             * and its own continuations complete with the -1 result without starting.
+             */
+            virtual ~Future();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Executes the user task, and starts its continuations.
+             *
+             * @return the user task result.
+             */        
+            virtual int32 start();
+            
+            /**
+             * Returns size of stack.
+             *
+             * @return the user task stack size in bytes.
+             */
+            virtual int32 getStackSize() const;
+            
+            /**
+             * Tests if the task has completed.
+             *
+             * @return true if the result is ready.
+             */
+            bool isReady() const;
+            
+            /**
+             * Waits for the completion of the task.
+             *
+             * @return true if the result is ready.
+             */
+            bool wait();
+            
+            /**
+             * Waits for the completion of the task during a timeout.
+             *
+             * @param millis a timeout in milliseconds, or zero for a test without waiting.
+             * @return true if the result is ready.
+             */
+            bool wait(int64 millis);
+            
+            /**
+             * Waits for the completion of the task, and returns its result.
+             *
+             * @return the value returned by the task start function, or -1 if the task has not been executed.
+             */
+            int32 get();
+            
+            /**
+             * Creates a continuation of the task.
+             *
+             * The continuation task is started in a new thread after the completion of this task, 
+             * so it might get the result of this future without blocking.
+             *
+             * @param task a user task.
+             * @return a new future of the continuation task, or NULL if an error has been occurred.
+             */
+            Future* then(api::Task& task);
+            
+        private:
+        
+            /** 
+             * Constructor of a continuation.
+             *
+             * @param scheduler  the scheduler which creates a thread of the task.
+             * @param task       a user task.
+             * @param antecedent the future after which the task is started.
+             */
+            Future(api::Scheduler& scheduler, api::Task& task, Future& antecedent);
+        
+            /**
+             * Constructor.
+             *
+             * @param antecedent the future after which the task is started, or NULL to start it at once.
+             * @return true if object has been constructed successfully.
+             */
+            bool construct(Future* antecedent);
+            
+            /**
+             * Starts the task in a new thread.
+             *
+             * If the thread is not created, the future completes with an error.
+             */
+            void execute();
+            
+            /**
+             * Completes the future with a result, and starts or cancels the continuations.
+             *
+             * @param result      the task result.
+             * @param isContinued true for starting the continuations, or false for cancelling them.
+             */
+            void complete(int32 result, bool isContinued);
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Future(const Future& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            Future& operator =(const Future& obj);
+            
+            /**
+             * The scheduler which creates a thread of the task.
+             */
+            api::Scheduler& scheduler_;
+            
+            /**
+             * The user task.
+             */
+            api::Task& task_;
+            
+            /**
+             * The task result.
+             */
+            int32 result_;
+            
+            /**
+             * The latch opened on completion of the task.
+             */
+            Latch ready_;
+            
+            /**
+             * The thread of the task.
+             */
+            api::Thread* thread_;
+            
+            /**
+             * The future after which this task is started, until it is started.
+             */
+            Future* antecedent_;
+            
+            /**
+             * The continuations which have not been started.
+             */
+            Future* continuations_;
+            
+            /**
+             * The next continuation of the antecedent.
+             */
+            Future* next_;
+        
+        };
+    }
+}
+#endif // SYSTEM_FUTURE_HPP_
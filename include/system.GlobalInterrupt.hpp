@@ -11,6 +11,7 @@
 #include "os.h"
 #include "system.Object.hpp"
 #include "api.Toggle.hpp"
+#include "system.BootTrace.hpp"
 
 namespace local
 {
@@ -28,6 +29,7 @@ namespace local
              */
             GlobalInterrupt() : Parent()
             {
+                BootTrace::mark("GlobalInterrupt");
             }  
             
             /** 
@@ -54,7 +54,7 @@ namespace local
              */ 
             virtual bool disable()
             {
-                return prc_disable() == 0 ? false : true;
+                return disableAll();
             }        
             
             /** 
@@ -64,8 +64,28 @@ namespace local
              */    
             virtual void enable(bool status)
             {
-                prc_enable(status == true ? 1 : 0);  
+                enableAll(status);
             }        
+            
+            /** 
+             * Disables the global thread switching.
+             *
+             * @return true if the switching was enabled before the method was called.
+             */ 
+            static bool disableAll()
+            {
+                return prc_disable() == 0 ? false : true;
+            }
+            
+            /** 
+             * Enables the global thread switching.
+             *
+             * @param status the returned status by disable method.
+             */    
+            static void enableAll(bool const status)
+            {
+                prc_enable(status == true ? 1 : 0);
+            }
           
         private:
         
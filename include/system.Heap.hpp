@@ -10,6 +10,7 @@
 
 #include "system.Object.hpp"
 #include "api.Heap.hpp"
+#include "system.Allocator.hpp"
 
 namespace local
 {
@@ -56,6 +57,28 @@ namespace local
              * @param ptr - pointer to allocated memory.
              */      
             virtual void free(void* ptr);
+            
+            /**
+             * Changes the size of an allocated memory.
+             *
+             * The memory is resized in place if the adjacent memory allows, 
+             * and it is moved to a new block otherwise.
+             *
+             * @param ptr  - pointer to allocated memory, or NULL for allocating.
+             * @param size - required memory size in byte.
+             * @return pointer to resized memory, or NULL if the memory is not resized.
+             */
+            void* reallocate(void* ptr, size_t size);
+            
+            /**
+             * Reports the free space and the fragmentation of the heap.
+             *
+             * The walking of the heap blocks disables the interrupts 
+             * for one allocator arena at a time.
+             *
+             * @param space the free space.
+             */
+            void getFreeSpace(Allocator::FreeSpace& space) const;
     
         };
     }
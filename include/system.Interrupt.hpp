@@ -16,12 +16,61 @@ namespace local
 {
     namespace system
     {
+        class InterruptService;
+    
         class Interrupt : public system::Object, public api::Interrupt
         {
             typedef system::Interrupt Self;
             typedef system::Object    Parent;
         
         public:
+        
+            /**
+             * The number of handler duration histogram bins.
+             */
+            static const int32 HISTOGRAM_SIZE = 16;
+        
+            /**
+             * Statistics of an interrupt vector.
+             *
+             * The statistics are collected if the SYSTEM_INTERRUPT_STATISTICS macro is defined.
+             * The handler duration includes durations of nested interrupts, and the zero bin 
+             * of the histogram counts durations less than one microsecond, and an other bin 
+             * counts durations in range [2^(bin-1), 2^bin) microseconds, while the last bin 
+             * also counts all longer durations.
+             */
+            struct Statistics
+            {
+                /**
+                 * The number of handler executions.
+                 */
+                uint32 count;
+                
+                /**
+                 * The minimal handler duration in nanoseconds.
+                 */
+                int64 min;
+                
+                /**
+                 * The maximal handler duration in nanoseconds.
+                 */
+                int64 max;
+                
+                /**
+                 * The total handler duration in nanoseconds for calculating a mean duration.
+                 */
+                int64 total;
+                
+                /**
+                 * The maximal interrupts nesting level the handler has been executed on.
+                 */
+                int32 nesting;
+                
+                /**
+                 * The handler duration histogram.
+                 */
+                uint32 histogram[HISTOGRAM_SIZE];
+            };
             
             /** 
              * Constructor.
@@ -31,6 +80,18 @@ namespace local
              */     
             Interrupt(api::Task& handler, int32 source);
             
+            /** 
+             * Constructor of a deferred interrupt.
+             *
+             * The interrupt context only posts the handler to the service, 
+             * and the handler is executed by the service thread.
+             *
+             * @param handler user class which implements an interrupt handler interface.
+             * @param source  available interrupt source.
+             * @param service deferred interrupt processing service.
+             */     
+            Interrupt(api::Task& handler, int32 source, InterruptService& service);
+            
             /** 
              * Destructor.
              */
@@ -45,9 +106,30 @@ namespace local
             
             /**
              * Jumps to interrupt hardware vector.
+             *
+             * The method waits for the interrupt handler completion.
              */      
             virtual void jump();    
             
+            /**
+             * Jumps to interrupt hardware vector.
+             *
+             * The waiting blocks the caller on a semaphore until the handler
+             * completion, therefore the method must not be called with the waiting 
+             * in the interrupt context or when all maskable interrupts are disabled.
+             *
+             * @param isWait true if the method waits for the interrupt handler completion.
+             * @return true if the interrupt has been raised, and has been handled if it is waited.
+             */      
+            bool jump(bool isWait);
+            
+            /**
+             * Tests if a jump to interrupt hardware vector has not been handled yet.
+             *
+             * @return true if the interrupt handler has not completed after the last jump.
+             */      
+            bool isJumping() const;
+            
             /**
              * Clears an interrupt status of this source.
              */     
@@ -96,82 +178,161 @@ namespace local
              * @param status the returned status by disable method.
              */
             static void enableAll(bool status=true);        
+            
+            /**
+             * The number of interrupt vector methods.
+             *
+             * The value must not be greater than WORD_BITS * WORD_BITS.
+             */        
+            static const int32 HANDLERS_NUMBER = 64;
+            
+            /**
+             * Completes an interrupt handler execution.
+             *
+             * The method releases the threads waiting for the handler completion
+             * after a jump. It is called by the deferred interrupt processing service 
+             * when a deferred handler has been executed.
+             *
+             * @param vector an index of the interrupt handlers table.
+             */
+            static void complete(int32 vector);
+            
+            /**
+             * Returns statistics of an interrupt vector.
+             *
+             * @param vector an index of the interrupt handlers table.
+             * @param stats  the statistics to be filled.
+             * @return true if the statistics have been returned.
+             */
+            static bool getStatistics(int32 vector, Statistics& stats);
+            
+            /**
+             * Resets statistics of an interrupt vector.
+             *
+             * @param vector an index of the interrupt handlers table.
+             */
+            static void resetStatistics(int32 vector);
+            
+            /**
+             * Returns statistics of this interrupt.
+             *
+             * @param stats the statistics to be filled.
+             * @return true if the statistics have been returned.
+             */
+            bool getStatistics(Statistics& stats) const;
+            
+            /**
+             * Resets statistics of this interrupt.
+             */
+            void resetStatistics();
         
         private:
+        
+            /**
+             * Interrupt vector type.
+             */
+            typedef void (*Vector)();
           
             /**
              * Constructor.
              *
              * @param handler pointer to user class which implements an interrupt handler interface.   
              * @param source  available interrupt source.     
+             * @param service deferred interrupt processing service, or NULL.
              * @return true if object has been constructed successfully.     
              */    
-            bool construct(api::Task* handler, int32 source);
+            bool construct(api::Task* handler, int32 source, InterruptService* service);
             
-            /** 
-             * Interrupt hanlder vector number 0.
+            /**
+             * Allocates a free index in the interrupt handlers table.
+             *
+             * @return the index, or -1 if all indexes are allocated.
              */
-            static void handler00();
+            static int32 allocateIndex();
             
-            /** 
-             * Interrupt hanlder vector number 1.
+            /**
+             * Frees an index in the interrupt handlers table.
+             *
+             * @param index an allocated index.
              */
-            static void handler01();
+            static void freeIndex(int32 index);
             
-            /** 
-             * Interrupt hanlder vector number 2.
+            /**
+             * Returns a mask of the lowest bits of a word.
+             *
+             * @param count the number of the lowest bits to be set.
+             * @return the mask.
              */
-            static void handler02();
-            
-            /** 
-             * Interrupt hanlder vector number 3.
-             */        
-            static void handler03();           
+            static uint32 getMask(int32 count);
             
-            /** 
-             * Interrupt hanlder vector number 4.
-             */        
-            static void handler04();
-            
-            /** 
-             * Interrupt hanlder vector number 5.
-             */       
-            static void handler05();
-            
-            /** 
-             * Interrupt hanlder vector number 6.
+            /**
+             * Returns a number of the lowest set bit of a word.
+             *
+             * @param word a non-zero word.
+             * @return the bit number.
              */
-            static void handler06();
-            
-            /** 
-             * Interrupt hanlder vector number 7.
-             */        
-            static void handler07();
+            static int32 getLowestBit(uint32 word);
             
             /** 
-             * Interrupt hanlder vector number 8.
-             */        
-            static void handler08();
-            
-            /** 
-             * Interrupt hanlder vector number 9.
-             */        
-            static void handler09();
-            
-            /** 
-             * Interrupt hanlder vector number 10.
-             */        
-            static void handler10();
+             * Interrupt hanlder vector.
+             *
+             * @param VECTOR a vector number in the interrupt handlers table.
+             */
+            template <int32 VECTOR>
+            static void trampoline()
+            {
+                handler(VECTOR);
+            }
             
-            /** 
-             * Interrupt hanlder vector number 11.
-             */        
-            static void handler11();
+            /**
+             * Interrupt hanlder vectors table.
+             *
+             * The table is generated at compile time, and a vector is found 
+             * by binary division of the table, so the number of handlers can be
+             * changed by the HANDLERS_NUMBER constant only.
+             *
+             * @param BEGIN the first vector number of this table part.
+             * @param COUNT the number of vectors of this table part.
+             */
+            template <int32 BEGIN, int32 COUNT>
+            struct Vectors
+            {
+                /**
+                 * Returns an interrupt vector.
+                 *
+                 * @param index a vector number in range [BEGIN, BEGIN + COUNT).
+                 * @return the vector.
+                 */
+                static Vector get(int32 const index)
+                {
+                    if(index < BEGIN + COUNT / 2)
+                    {
+                        return Vectors<BEGIN, COUNT / 2>::get(index);
+                    }
+                    else
+                    {
+                        return Vectors<BEGIN + COUNT / 2, COUNT - COUNT / 2>::get(index);
+                    }
+                }
+            };
 
             /**
              * Interrupt hanlder.
              */
             static void handler(int32 vector);
+            
+            #ifdef SYSTEM_INTERRUPT_STATISTICS
+            
+            /**
+             * Records an interrupt handler execution to the vector statistics.
+             *
+             * @param vector   an index of the interrupt handlers table.
+             * @param duration the handler duration in nanoseconds.
+             * @param nesting  the interrupts nesting level of the handler.
+             */
+            static void record(int32 vector, int64 duration, int32 nesting);
+            
+            #endif // SYSTEM_INTERRUPT_STATISTICS
                     
             /**
              * Copy constructor.
@@ -189,24 +350,73 @@ namespace local
             Interrupt& operator =(const Interrupt& obj);
         
             /**
-             * The number of interrupt vector methods.
+             * The number of bits in a word of allocated indexes bitmap.
+             */        
+            static const int32 WORD_BITS = 32;
+            
+            /**
+             * The number of words of allocated indexes bitmap.
              */        
-            static const int32 HANDLERS_NUMBER = 12;        
+            static const int32 WORDS_NUMBER = (HANDLERS_NUMBER + WORD_BITS - 1) / WORD_BITS;
             
             /**
              * Interrupt handlers.
              */        
             static api::Task* handler_[HANDLERS_NUMBER];
             
+            /**
+             * Deferred interrupt processing services of handlers.
+             */        
+            static InterruptService* service_[HANDLERS_NUMBER];
+            
+            /**
+             * Allocated indexes bitmap of interrupt handlers table.
+             */        
+            static uint32 indexes_[WORDS_NUMBER];
+            
+            /**
+             * Bitmap of completely allocated words of the indexes bitmap.
+             */        
+            static uint32 words_;
+            
             /**
              * An interrupt resource is called jump method.
              */        
             static bool isJumping_[HANDLERS_NUMBER];        
             
+            /**
+             * The number of threads waiting for the handler completion.
+             */        
+            static int32 waiters_[HANDLERS_NUMBER];        
+            
+            /**
+             * The OS semaphore resources of waiting for the handler completion.
+             */        
+            static uint32 semaphore_[HANDLERS_NUMBER];        
+            
+            #ifdef SYSTEM_INTERRUPT_STATISTICS
+            
+            /**
+             * Statistics of interrupt vectors.
+             */        
+            static Statistics statistics_[HANDLERS_NUMBER];
+            
+            /**
+             * The current interrupts nesting level.
+             */        
+            static int32 nesting_;
+            
+            #endif // SYSTEM_INTERRUPT_STATISTICS
+            
             /**
              * The OS resource.
              */
             uint32 res_;
+            
+            /**
+             * The OS semaphore resource of waiting for the handler completion.
+             */
+            uint32 sem_;
         
             /**
              * An index of this resource in interrupt handlers table.
@@ -214,6 +424,26 @@ namespace local
             int32 index_;
         
         };
+        
+        /**
+         * Interrupt hanlder vectors table of one vector.
+         *
+         * @param BEGIN the vector number.
+         */
+        template <int32 BEGIN>
+        struct Interrupt::Vectors<BEGIN, 1>
+        {
+            /**
+             * Returns an interrupt vector.
+             *
+             * @param index the vector number.
+             * @return the vector.
+             */
+            static Interrupt::Vector get(int32)
+            {
+                return &Interrupt::trampoline<BEGIN>;
+            }
+        };
     }
 }
 #endif // SYSYEM_INTERRUPT_HPP_
@@ -0,0 +1,183 @@
+/** 
+ * Deferred interrupt processing service.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_INTERRUPT_SERVICE_HPP_
+#define SYSTEM_INTERRUPT_SERVICE_HPP_
+
+#include "system.Object.hpp"
+#include "api.Task.hpp"
+#include "api.Scheduler.hpp"
+#include "system.Interrupt.hpp"
+#include "system.Semaphore.hpp"
+#include "system.Mutex.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class InterruptService : public system::Object, public api::Task
+        {
+            typedef system::InterruptService Self;
+            typedef system::Object           Parent;
+        
+        public:
+            
+            /** 
+             * Constructor.
+             *
+             * @param scheduler the scheduler which creates a service thread.
+             */     
+            InterruptService(api::Scheduler& scheduler);
+            
+            /** 
+             * Destructor.
+             */
+            virtual ~InterruptService();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Executes deferred interrupt handlers.
+             *
+             * @return zero, or error code if an error has been occurred.
+             */        
+            virtual int32 start();
+            
+            /**
+             * Returns size of stack.
+             *
+             * @return stack size in bytes.
+             */
+            virtual int32 getStackSize() const;
+            
+            /**
+             * Attaches a deferred handler of an interrupt vector.
+             *
+             * The service thread is created on attaching the first handler.
+             *
+             * @param vector  an index of the interrupt handlers table.
+             * @param handler a user interrupt handler.
+             * @return true if the handler has been attached successfully.
+             */
+            bool attach(int32 vector, api::Task& handler);
+            
+            /**
+             * Detaches a deferred handler of an interrupt vector.
+             *
+             * The method waits for the handler completion if it is being executed,
+             * therefore it must not be called in the interrupt context.
+             *
+             * @param vector an index of the interrupt handlers table.
+             */
+            void detach(int32 vector);
+            
+            /**
+             * Posts a deferred handler of an interrupt vector for executing.
+             *
+             * The method is called in the interrupt context. If the handler
+             * has been posted and has not been executed yet, the requests are 
+             * coalesced into one execution of the handler.
+             *
+             * @param vector an index of the interrupt handlers table.
+             */
+            void post(int32 vector);
+        
+        private:
+          
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.     
+             */    
+            bool construct();
+            
+            /**
+             * Creates the service thread if it has not been created.
+             *
+             * @return true if the service thread has been created.
+             */
+            bool createThread();
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            InterruptService(const InterruptService& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            InterruptService& operator =(const InterruptService& obj);
+            
+            /**
+             * The service thread stack size in bytes.
+             */        
+            static const int32 STACK_SIZE = 0x1000;
+            
+            /**
+             * The number of bits in a word of pending handlers bitmap.
+             */        
+            static const int32 WORD_BITS = 32;
+            
+            /**
+             * The number of words of pending handlers bitmap.
+             */        
+            static const int32 WORDS_NUMBER = (Interrupt::HANDLERS_NUMBER + WORD_BITS - 1) / WORD_BITS;
+            
+            /**
+             * Deferred interrupt handlers.
+             */        
+            api::Task* handler_[Interrupt::HANDLERS_NUMBER];
+            
+            /**
+             * Pending handlers bitmap.
+             */        
+            uint32 pending_[WORDS_NUMBER];
+            
+            /**
+             * The service thread has been released for executing pending handlers.
+             */        
+            bool isPending_;
+            
+            /**
+             * The service thread is requested to stop.
+             */        
+            bool isStopping_;
+            
+            /**
+             * The semaphore releases the service thread.
+             */        
+            Semaphore sem_;
+            
+            /**
+             * The mutex is locked while a handler is being executed.
+             */        
+            Mutex mutex_;
+            
+            /**
+             * The scheduler which creates the service thread.
+             */        
+            api::Scheduler& scheduler_;
+            
+            /**
+             * The service thread.
+             */        
+            api::Thread* thread_;
+        
+        };
+    }
+}
+#endif // SYSTEM_INTERRUPT_SERVICE_HPP_
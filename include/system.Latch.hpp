@@ -0,0 +1,122 @@
+/** 
+ * One-shot countdown latch.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_LATCH_HPP_
+#define SYSTEM_LATCH_HPP_
+
+#include "system.Object.hpp"
+#include "system.Semaphore.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class Latch : public system::Object
+        {
+            typedef system::Latch  Self;
+            typedef system::Object Parent;
+        
+        public:
+        
+            /** 
+             * Constructor.
+             *
+             * @param count the number of count downs to open the latch.
+             */
+            Latch(int32 count);
+            
+            /** 
+             * Destructor.
+             */
+            virtual ~Latch();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Decrements the count, and opens the latch if the count reaches zero.
+             *
+             * The function might be called by an interrupt handler.
+             */
+            void countDown();
+            
+            /**
+             * Waits until the latch is open.
+             *
+             * @return true if the latch is open.
+             */
+            bool await();
+            
+            /**
+             * Waits until the latch is open during a timeout.
+             *
+             * @param millis a timeout in milliseconds, or zero for a test without waiting.
+             * @return true if the latch is open.
+             */
+            bool await(int64 millis);
+            
+            /**
+             * Tests if the latch is open.
+             *
+             * @return true if the count has reached zero.
+             */
+            bool isOpen() const;
+            
+        private:
+        
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct();
+            
+            /**
+             * Counts the calling thread as a waiting one if the latch is not open.
+             *
+             * @return true if the thread has to wait.
+             */
+            bool wait();
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Latch(const Latch& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            Latch& operator =(const Latch& obj);
+            
+            /**
+             * The number of count downs left.
+             */
+            volatile int32 count_;
+            
+            /**
+             * The number of threads waiting for the latch.
+             */
+            int32 waiting_;
+            
+            /**
+             * The gate semaphore, which is released once for each waiting thread.
+             */
+            Semaphore gate_;
+        
+        };
+    }
+}
+#endif // SYSTEM_LATCH_HPP_
@@ -11,6 +11,10 @@
 #include "os.h"
 #include "system.Object.hpp"
 #include "api.Mutex.hpp"
+#include "system.Trace.hpp"
+#include "system.Scheduler.hpp"
+#include "system.Clock.hpp"
+#include "system.Coroutine.hpp"
 
 namespace local
 {
@@ -20,6 +24,8 @@ namespace local
         {
                 typedef system::Mutex  Self;
                 typedef system::Object Parent;
+                
+                friend class system::Coroutine;
       
         public:
       
@@ -27,7 +33,8 @@ namespace local
              * Constructor.
              */    
             Mutex() : Parent(),
-                res_ (RES_VOID){
+                res_        (RES_VOID),
+                coroutines_ (0){
                 bool const isConstructed = construct();
                 setConstructed( isConstructed );              
             }        
@@ -62,7 +69,31 @@ namespace local
             virtual bool lock()
             {
                 if( not Self::isConstructed() ) return false;
-                return sem_lock(res_, SEM_INFINITY) == SEM_OK ? true : false;        
+                Trace::record(Trace::MUTEX_WAIT, res_);
+                bool const isLocked = lockResource(SEM_INFINITY);
+                if(isLocked)
+                {
+                    Trace::record(Trace::MUTEX_LOCK, res_);
+                }
+                return isLocked;
+            }
+            
+            /**
+             * Locks the mutex if it is unlocked during a timeout.
+             *
+             * @param millis a timeout in milliseconds, or zero for a try without waiting.
+             * @return true if the mutex is lock successfully.
+             */      
+            bool tryLock(int64 millis)
+            {
+                if( not Self::isConstructed() ) return false;
+                if(millis < 0) return false;
+                bool const isLocked = lockResource( static_cast<uint32>(millis) );
+                if(isLocked)
+                {
+                    Trace::record(Trace::MUTEX_LOCK, res_);
+                }
+                return isLocked;
             }
             
             /**
@@ -71,7 +102,12 @@ namespace local
             virtual void unlock()
             {
                 if( not Self::isConstructed() ) return;
-                sem_unlock(res_);        
+                Trace::record(Trace::MUTEX_UNLOCK, res_);
+                sem_unlock(res_);
+                if(coroutines_ != 0)
+                {
+                    Coroutine::notifyAll();
+                }
             }
             
             /** 
@@ -92,6 +128,28 @@ namespace local
       
         private:
       
+            /**
+             * Locks the OS semaphore, and accounts the blocking of the current thread.
+             *
+             * @param timeout a timeout in milliseconds, zero for a try without waiting, or SEM_INFINITY.
+             * @return true if the OS semaphore is locked successfully.
+             */
+            bool lockResource(uint32 const timeout)
+            {
+                #ifdef SYSTEM_THREAD_STATISTICS
+                // Only the locking which has to wait switches the thread
+                if(timeout != 0)
+                {
+                    if(sem_lock(res_, 0) == SEM_OK) return true;
+                    int64 const time = Clock::getTime();
+                    bool const isLocked = sem_lock(res_, timeout) == SEM_OK ? true : false;
+                    Scheduler::recordBlocking(Clock::getTime() - time);
+                    return isLocked;
+                }
+                #endif
+                return sem_lock(res_, timeout) == SEM_OK ? true : false;
+            }
+            
             /**
              * Constructor.
              *
@@ -123,6 +181,11 @@ namespace local
              * The porting OS resource.
              */
             uint32 res_;        
+            
+            /**
+             * The number of coroutines waiting for the mutex.
+             */
+            volatile int32 coroutines_;
       
         };
     }
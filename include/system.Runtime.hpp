@@ -13,6 +13,9 @@
 #include "system.Object.hpp"
 #include "api.Runtime.hpp"
 #include "system.Interrupt.hpp"
+#include "system.Mutex.hpp"
+#include "system.RuntimeLoading.hpp"
+#include "system.BootTrace.hpp"
 
 namespace local
 {
@@ -28,8 +31,12 @@ namespace local
             /** 
              * Constructor.
              */     
-            Runtime() : Parent()
-            { 
+            Runtime() : Parent(),
+                mutex_  (),
+                loader_ (RES_VOID){
+                name_[0] = '\0';
+                setConstructed( construct() );
+                BootTrace::mark("Runtime");
             }
           
             /** 
@@ -58,15 +65,41 @@ namespace local
             virtual bool load(const char* path)
             {
                 if( not Self::isConstructed() ) return false;        
-                char name[32];
-                int32 error = sys_getname(name, sizeof(name));
-                if(error != OSE_OK) return false;
-                uint32 res = msg_discover(name, "os", TIMEOUT_MS);
-                if(res != RES_VOID) return false;
-                error = mapi_loadafterme(res, path, NULL);
-                return error == OSE_OK ? true : false;
+                bool isCached = loader_ != RES_VOID;
+                while(true)
+                {
+                    uint32 const res = discover();
+                    if(res == RES_VOID) break;
+                    int32 const error = mapi_loadafterme(res, path, NULL);
+                    if(error == OSE_OK) return true;
+                    // A failed loader might be gone, and it is discovered again only once if it has been cached
+                    invalidate(res);
+                    if( not isCached ) break;
+                    isCached = false;
+                }
+                return false;
             }
       
+            /**
+             * Loads a program for executing asynchronously.
+             *
+             * @param path a system path to a program.
+             * @return the loading, or NULL if an error has been occurred.
+             */    
+            RuntimeLoading* loadAsync(const char* path);
+            
+            /**
+             * Loads programs for executing asynchronously.
+             *
+             * The loader requests of the programs are pipelined, 
+             * and the path strings must exist until the loading is completed.
+             *
+             * @param paths  system paths to programs.
+             * @param number the number of the paths.
+             * @return the loading, or NULL if an error has been occurred.
+             */    
+            RuntimeLoading* loadAsync(const char* const* paths, int32 number);
+      
             /**
              * Terminates a system execution.
              *
@@ -82,6 +115,65 @@ namespace local
             }
             
         private:   
+        
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct()
+            {
+                if( not Self::isConstructed() ) return false;
+                if( not mutex_.isConstructed() ) return false;
+                return true;
+            }
+            
+            /**
+             * Returns the OS loader resource.
+             *
+             * The loader is discovered once, and is cached 
+             * until a loading by it fails.
+             *
+             * @return the loader resource, or RES_VOID if an error has been occurred.
+             */
+            uint32 discover()
+            {
+                if( not mutex_.lock() ) return RES_VOID;
+                if(loader_ == RES_VOID)
+                {
+                    if(name_[0] == '\0')
+                    {
+                        if(sys_getname(name_, sizeof(name_)) != OSE_OK)
+                        {
+                            name_[0] = '\0';
+                        }
+                    }
+                    if(name_[0] != '\0')
+                    {
+                        loader_ = msg_discover(name_, "os", TIMEOUT_MS);
+                    }
+                }
+                uint32 const res = loader_;
+                mutex_.unlock();
+                return res;
+            }
+            
+            /**
+             * Invalidates the cached OS loader resource.
+             *
+             * @param res the loader resource a loading by which has failed.
+             */
+            void invalidate(uint32 const res)
+            {
+                if( not mutex_.lock() ) return;
+                // Other thread might have discovered a new loader
+                if(loader_ == res)
+                {
+                    loader_ = RES_VOID;
+                    name_[0] = '\0';
+                }
+                mutex_.unlock();
+            }
             
             /**
              * Copy constructor.
@@ -102,6 +194,26 @@ namespace local
              * A timeout in ms.
              */          
             static const uint32 TIMEOUT_MS = 5000;
+            
+            /** 
+             * The process name size.
+             */          
+            static const int32 NAME_SIZE = 32;
+            
+            /**
+             * The mutex of the cached loader.
+             */
+            Mutex mutex_;
+            
+            /**
+             * The cached OS loader resource.
+             */
+            uint32 loader_;
+            
+            /**
+             * The cached process name.
+             */
+            char name_[NAME_SIZE];
     
         };
     }
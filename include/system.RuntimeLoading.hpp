@@ -0,0 +1,170 @@
+/**
+ * Asynchronous loading of programs.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_RUNTIME_LOADING_HPP_
+#define SYSTEM_RUNTIME_LOADING_HPP_
+
+#include "system.Object.hpp"
+#include "api.Task.hpp"
+#include "api.Runtime.hpp"
+#include "api.Scheduler.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class RuntimeLoading : public system::Object, public api::Task
+        {
+            typedef system::RuntimeLoading Self;
+            typedef system::Object         Parent;
+          
+        public:
+        
+            /**
+             * The maximum number of programs of one loading.
+             */
+            static const int32 PATHS_NUMBER = 32;
+        
+            /** 
+             * Constructor.
+             *
+             * The programs are loaded by several threads, therefore loader requests
+             * of the programs are pipelined, and the loading order is not guaranteed.
+             * The path strings must exist until the loading is completed.
+             *
+             * @param runtime   the runtime which loads the programs.
+             * @param scheduler the scheduler which creates loading threads.
+             * @param paths     system paths to programs.
+             * @param number    the number of the paths.
+             */     
+            RuntimeLoading(api::Runtime& runtime, api::Scheduler& scheduler, const char* const* paths, int32 number);
+          
+            /** 
+             * Destructor.
+             *
+             * Waits for the loading completion.
+             */
+            virtual ~RuntimeLoading();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Loads programs in a loading thread.
+             *
+             * @return zero.
+             */        
+            virtual int32 start();
+            
+            /**
+             * Returns size of stack.
+             *
+             * @return stack size in bytes.
+             */
+            virtual int32 getStackSize() const;
+            
+            /**
+             * Tests if all programs have been processed.
+             *
+             * @return true if the loading has been completed.
+             */
+            bool isDone() const;
+            
+            /**
+             * Waits for the loading completion.
+             *
+             * @return true if all programs have been loaded successfully.
+             */
+            bool wait();
+            
+            /**
+             * Tests if a program has been loaded.
+             *
+             * @param index an index of the program path.
+             * @return true if the program has been loaded successfully.
+             */
+            bool isLoaded(int32 index) const;
+            
+        private:   
+        
+            /**
+             * Constructor.
+             *
+             * @param scheduler the scheduler which creates loading threads.
+             * @param paths     system paths to programs.
+             * @return true if object has been constructed successfully.
+             */
+            bool construct(api::Scheduler& scheduler, const char* const* paths);
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            RuntimeLoading(const RuntimeLoading& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            RuntimeLoading& operator =(const RuntimeLoading& obj);
+            
+            /**
+             * The maximum number of loading threads.
+             */
+            static const int32 THREADS_NUMBER = 4;
+            
+            /**
+             * The loading thread stack size in bytes.
+             */
+            static const int32 STACK_SIZE = 0x1000;
+            
+            /**
+             * The runtime which loads the programs.
+             */
+            api::Runtime& runtime_;
+            
+            /**
+             * System paths to the programs.
+             */
+            const char* paths_[PATHS_NUMBER];
+            
+            /**
+             * The programs have been loaded successfully.
+             */
+            bool isLoaded_[PATHS_NUMBER];
+            
+            /**
+             * The number of the programs.
+             */
+            int32 number_;
+            
+            /**
+             * The index of the next program to be loaded.
+             */
+            int32 next_;
+            
+            /**
+             * The number of processed programs.
+             */
+            int32 done_;
+            
+            /**
+             * The loading threads.
+             */
+            api::Thread* threads_[THREADS_NUMBER];
+    
+        };
+    }
+}
+#endif // SYSTEM_RUNTIME_LOADING_HPP_
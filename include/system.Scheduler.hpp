@@ -18,6 +18,7 @@ namespace local
     namespace system
     {
         class SchedulerThread;
+        class Future;
 
         class Scheduler : public system::Object, public api::Scheduler
         {
@@ -25,6 +26,42 @@ namespace local
             typedef system::Object    Parent;
       
         public:
+        
+            /**
+             * Statistics of a thread.
+             */
+            struct ThreadStatistics
+            {
+                /**
+                 * The thread identifier.
+                 */
+                int64 id;
+                
+                /**
+                 * The time since the thread task has started in nanoseconds.
+                 */
+                int64 time;
+                
+                /**
+                 * The time the thread has not been waiting in nanoseconds.
+                 */
+                int64 active;
+                
+                /**
+                 * The time the thread has been blocked on semaphores and mutexes in nanoseconds.
+                 */
+                int64 blocked;
+                
+                /**
+                 * The time the thread has been sleeping in nanoseconds.
+                 */
+                int64 sleeping;
+                
+                /**
+                 * The number of voluntary thread switches.
+                 */
+                uint32 switches;
+            };
       
             /** 
              * Constructor.
@@ -51,6 +88,14 @@ namespace local
              */
             virtual api::Thread* createThread(api::Task& task);
             
+            /**
+             * Submits a task for executing in a new thread.
+             *
+             * @param task an user task which main method will be invoked in a new thread at once.
+             * @return a new future of the task result.
+             */
+            Future* submit(api::Task& task);
+            
             /**
              * Returns currently executing thread.
              *
@@ -70,6 +115,35 @@ namespace local
              */ 
             virtual api::Toggle& toggle();
             
+            /**
+             * Returns the high-water mark of a thread stack usage.
+             *
+             * @param thread a thread created by this scheduler, which might be dead.
+             * @return the maximum number of used stack bytes, or -1 if the stack is not painted.
+             */
+            int32 getStackUsage(const api::Thread& thread) const;
+            
+            /**
+             * Copies statistics of the threads being executed.
+             *
+             * The statistics are collected if the SYSTEM_THREAD_STATISTICS macro is defined.
+             * The thread switches caused by the waiting system calls are counted, 
+             * but the preemptions are not visible to the scheduler, therefore 
+             * the active time includes the time the thread has been preempted.
+             *
+             * @param stats  a buffer for copying the statistics to.
+             * @param number the number of statistics the buffer can contain.
+             * @return the number of copied statistics.
+             */
+            int32 getStatistics(ThreadStatistics* stats, int32 number) const;
+            
+            /**
+             * Records a blocking of the current thread.
+             *
+             * @param duration the blocking duration in nanoseconds.
+             */
+            static void recordBlocking(int64 duration);
+            
             /**
              * Adds a thread to execution list
              *
@@ -112,6 +186,20 @@ namespace local
              */
             Scheduler& operator =(const Scheduler& obj);
             
+            #ifdef SYSTEM_THREAD_STATISTICS
+            /**
+             * Returns currently executing thread if it has been created by the scheduler.
+             *
+             * @return executing thread, or NULL if it is not found.
+             */
+            SchedulerThread* findCurrentThread() const;
+            
+            /**
+             * The scheduler, which has been constructed.
+             */
+            static Scheduler* scheduler_;
+            #endif // SYSTEM_THREAD_STATISTICS
+            
             /** 
              * Global thread switching controller.
              */        
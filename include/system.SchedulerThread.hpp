@@ -12,8 +12,10 @@
 #include "system.Object.hpp"
 #include "api.Thread.hpp"
 #include "api.Task.hpp"
-#include "system.Semaphore.hpp"
-#include "system.Interrupt.hpp"
+#include "system.CriticalSection.hpp"
+#include "system.Trace.hpp"
+#include "system.Scheduler.hpp"
+#include "system.Clock.hpp"
 
 namespace local
 {
@@ -32,13 +34,26 @@ namespace local
              * @param task a task interface whose main method is invoked when this thread is started.         
              */
             SchedulerThread(api::Task& task, Scheduler* scheduler) : Parent(),
-                sem_           (0),
                 task_          (&task),
                 scheduler_     (scheduler),            
                 id_            (-1),
                 res_           (-1),
+                result_        (-1),
+                priority_      (NORM_PRIORITY),
                 status_        (NEW),
                 this_          (this){
+                #ifdef SYSTEM_STACK_WATERMARK
+                stackTop_ = 0;
+                stackLow_ = NULL;
+                stackHigh_ = NULL;
+                stackUsage_ = -1;
+                #endif
+                #ifdef SYSTEM_THREAD_STATISTICS
+                startTime_ = -1;
+                blocked_ = 0;
+                sleeping_ = 0;
+                switches_ = 0;
+                #endif
                 setConstructed( construct() );
             }    
             
@@ -62,25 +77,63 @@ namespace local
             
             /**
              * Causes this thread to begin execution.
+             *
+             * The process of the porting OS is created here, so a thread 
+             * which has not been executed holds no OS resources.
              */
             virtual void execute()
             {
                 if( not Self::isConstructed() ) return;
+                // Create new thread of the porting OS
+                s_prc_attr attr;
+                // Set size of thread stack
+                attr.stack = task_->getStackSize();
+                // Set default OS heap
+                attr.heap = 0x100;
+                // Set the priority, where the normal priority is the default one of the OS
+                attr.priority = priority_ != NORM_PRIORITY ? priority_ : 0;
+                // Set default address of .bss section
+                attr.bss = 0;
+                // Set no exit vector
+                attr.exit_vector = NULL;
+                // The process is published before it runs, and before this thread is joined
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("SchedulerThread::execute");
+                CriticalSection const cs(site, CriticalSection::THREADS);
                 if( status_ != NEW ) return;
-                bool is = Interrupt::disableAll();
+                // The thread is found by the created process, which might run at once
                 scheduler_->addThread(this);
-                status_ = RUNNABLE;                     
-                Interrupt::enableAll(is);            
-                sem_.release();
+                status_ = RUNNABLE;
+                int32 const res = prc_create(&run, &this_, sizeof(SchedulerThread*), &attr);
+                if(res < 0)
+                {
+                    status_ = DEAD;
+                    scheduler_->removeThread(this);
+                    return;
+                }
+                res_ = res;
+                Trace::record(Trace::THREAD_CREATE, static_cast<uint32>(res));
             }       
             
             /**
              * Waits for this thread to die.
+             *
+             * The joining waits for the executing thread to create the process.
              */  
             virtual void join()
             {
-                if( not Self::isConstructed() ) return;             
-                prc_join(res_);
+                if( not Self::isConstructed() ) return;
+                int32 res;
+                {
+                    static CriticalSection::Site site = CRITICAL_SECTION_SITE("SchedulerThread::join");
+                    CriticalSection const cs(site, CriticalSection::THREADS);
+                    res = res_;
+                }
+                int32 const result = prc_join(res);
+                // The next joining of the released process fails, so the first result is kept
+                if(status_ == DEAD && result_ == -1)
+                {
+                    result_ = result;
+                }
             }
             
             /**
@@ -102,7 +155,17 @@ namespace local
                 }
                 else
                 {
+                    #ifdef SYSTEM_THREAD_STATISTICS
+                    int64 const time = Clock::getTime();
                     sleep_m( static_cast<uint32>(millis) );
+                    // The sleeping is accounted if this thread is the current one
+                    if(id_ == static_cast<int64>( prc_id() ))
+                    {
+                        record(0, Clock::getTime() - time);
+                    }
+                    #else
+                    sleep_m( static_cast<uint32>(millis) );
+                    #endif
                 }
             }
             
@@ -119,7 +182,7 @@ namespace local
             /**
              * Returns the identifier of this thread.
              *
-             * @return the thread identifier, or -1 if an error has been occurred.
+             * @return the thread identifier, or -1 if the thread has not started yet.
              */
             virtual int64 getId() const
             {
@@ -133,16 +196,23 @@ namespace local
              */  
             virtual int32 getPriority() const
             {
-                return NORM_PRIORITY;
+                return Self::isConstructed() ? priority_ : -1;
             }
             
             /**
              * Sets this thread priority.
              *
-             * @param priority number of priority in range [MIN_PRIORITY, MAX_PRIORITY], or LOCK_PRIORITY.
+             * The priority is given to the OS process when this thread is executed,
+             * so the priority of an executed thread is not changed.
+             *
+             * @param priority number of priority in range [MIN_PRIORITY, MAX_PRIORITY].
              */  
             virtual void setPriority(int32 priority)
             {     
+                if( not Self::isConstructed() ) return;
+                if(status_ != NEW) return;
+                if(priority < MIN_PRIORITY || priority > MAX_PRIORITY) return;
+                priority_ = priority;
             }
     
             /**
@@ -155,8 +225,130 @@ namespace local
                 return Self::isConstructed() ? status_ : DEAD;
             }      
             
+            /**
+             * Returns the result of the joined thread task.
+             *
+             * @return the value returned by the task start function, or -1 if the thread has not been joined.
+             */
+            int32 getResult() const
+            {
+                return result_;
+            }
+            
+            /**
+             * Returns the high-water mark of the stack usage.
+             *
+             * The stack bounds are given by the OS when the thread starts, and the stack
+             * below the thread entry is painted with a pattern if the SYSTEM_STACK_WATERMARK
+             * macro is defined. The stack is supposed to grow down, and the usage is the
+             * number of bytes from the stack top to the lowest overwritten painted word.
+             * The stack of a running thread is scanned outside of critical sections, 
+             * so the thread must not be joined while its stack usage is being returned.
+             *
+             * @return the maximum number of used stack bytes, or -1 if the stack is not painted.
+             */
+            int32 getStackUsage() const
+            {
+                #ifdef SYSTEM_STACK_WATERMARK
+                {
+                    // The exiting thread records its usage in a critical section of the same type
+                    static CriticalSection::Site site = CRITICAL_SECTION_SITE("SchedulerThread::getStackUsage");
+                    CriticalSection const cs(site);
+                    if(status_ == DEAD || stackTop_ == 0) return stackUsage_;
+                }
+                return measure();
+                #else
+                return -1;
+                #endif
+            }
+            
+            /**
+             * Records a voluntary switch of this thread.
+             *
+             * @param blocked  the time of blocking on a resource in nanoseconds.
+             * @param sleeping the time of sleeping in nanoseconds.
+             */
+            void record(int64 const blocked, int64 const sleeping)
+            {
+                #ifdef SYSTEM_THREAD_STATISTICS
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("SchedulerThread::record");
+                CriticalSection const cs(site);
+                // The waiting for the execution is not accounted
+                if(startTime_ < 0) return;
+                blocked_ += blocked;
+                sleeping_ += sleeping;
+                switches_++;
+                #endif
+            }
+            
+            /**
+             * Copies statistics of this thread.
+             *
+             * @param stats statistics for copying to.
+             */
+            void getStatistics(Scheduler::ThreadStatistics& stats) const
+            {
+                stats.id = id_;
+                stats.time = 0;
+                stats.active = 0;
+                stats.blocked = 0;
+                stats.sleeping = 0;
+                stats.switches = 0;
+                #ifdef SYSTEM_THREAD_STATISTICS
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("SchedulerThread::getStatistics");
+                CriticalSection const cs(site);
+                if(startTime_ < 0) return;
+                stats.time = Clock::getTime() - startTime_;
+                stats.blocked = blocked_;
+                stats.sleeping = sleeping_;
+                stats.active = stats.time - blocked_ - sleeping_;
+                stats.switches = switches_;
+                #endif
+            }
+            
         private:
         
+            #ifdef SYSTEM_STACK_WATERMARK
+            /**
+             * Paints the stack of the current process below the calling function.
+             */
+            void paint()
+            {
+                void* addr;
+                size_t size;
+                if( prc_stack(&addr, &size) != OSE_OK ) return;
+                // The addresses are compared as integers, as the stack is not an object of the program
+                char frame;
+                size_t const low = (reinterpret_cast<size_t>(addr) + sizeof(uint32) - 1) & ~(sizeof(uint32) - 1);
+                size_t const high = (reinterpret_cast<size_t>(&frame) - STACK_MARGIN) & ~(sizeof(uint32) - 1);
+                if(high <= low) return;
+                stackLow_ = reinterpret_cast<volatile uint32*>(low);
+                stackHigh_ = reinterpret_cast<volatile uint32*>(high);
+                for(volatile uint32* word = stackLow_; word < stackHigh_; word++)
+                {
+                    *word = STACK_PATTERN;
+                }
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("SchedulerThread::paint");
+                CriticalSection const cs(site);
+                stackTop_ = reinterpret_cast<size_t>(addr) + size;
+            }
+            
+            /**
+             * Measures the stack usage.
+             *
+             * @return the maximum number of used stack bytes.
+             */
+            int32 measure() const
+            {
+                const volatile uint32* word = stackLow_;
+                while(word < stackHigh_ && *word == STACK_PATTERN)
+                {
+                    word++;
+                }
+                return static_cast<int32>( stackTop_ - reinterpret_cast<size_t>(word) );
+            }
+            #endif // SYSTEM_STACK_WATERMARK
+        
             /** 
              * Constructor.
              *                
@@ -166,22 +358,7 @@ namespace local
             {
                 if( not Self::isConstructed() ) return false;            
                 if( not task_->isConstructed() ) return false;
-                if( not sem_.isConstructed() ) return false;
-                // Create new thread of the porting OS
-                s_prc_attr attr;
-                // Set size of thread stack
-                attr.stack = task_->getStackSize();
-                // Set default OS heap
-                attr.heap = 0x100;
-                // Set default priority for this thread
-                attr.priority = 0;
-                // Set default address of .bss section
-                attr.bss = 0;
-                // Set no exit vector
-                attr.exit_vector = NULL;
-                res_ = prc_create(&run, &this_, sizeof(SchedulerThread*), &attr);
-                id_ = static_cast<int64>(res_);
-                return id_ >= 0 ? true : false;
+                return true;
             }
             
             /**
@@ -189,15 +366,34 @@ namespace local
              */  
             int32 run()
             {
-                // Wait for calling start method
-                sem_.acquire();
+                #ifdef SYSTEM_STACK_WATERMARK
+                paint();
+                #endif
+                // The identifier is set by the process, as it might run before the creating call returns
+                {
+                    static CriticalSection::Site site = CRITICAL_SECTION_SITE("SchedulerThread::run.start");
+                    CriticalSection const cs(site);
+                    id_ = static_cast<int64>( prc_id() );
+                    #ifdef SYSTEM_THREAD_STATISTICS
+                    startTime_ = Clock::getTime();
+                    #endif
+                }
                 // Call user main method
                 int32 const error = task_->start();
+                Trace::record(Trace::THREAD_EXIT, static_cast<uint32>(id_));
+                #ifdef SYSTEM_STACK_WATERMARK
+                int32 const usage = stackTop_ != 0 ? measure() : -1;
+                #endif
                 // Kill the thread
-                bool is = Interrupt::disableAll();
-                status_ = DEAD;            
-                scheduler_->removeThread(this);
-                Interrupt::enableAll(is);
+                {
+                    static CriticalSection::Site site = CRITICAL_SECTION_SITE("SchedulerThread::run");
+                    CriticalSection const cs(site);
+                    #ifdef SYSTEM_STACK_WATERMARK
+                    stackUsage_ = usage;
+                    #endif
+                    status_ = DEAD;            
+                    scheduler_->removeThread(this);
+                }
                 return static_cast<int>(error);
             }        
             
@@ -228,11 +424,6 @@ namespace local
              */
             SchedulerThread& operator =(const SchedulerThread& obj); 
     
-            /**
-             * The semaphore gives the started thread main method to start user task main method.
-             */        
-            Semaphore sem_;
-            
             /**
              * User executing runnable interface.
              */        
@@ -252,6 +443,16 @@ namespace local
              * Current identifier is a resource of porting OS process.
              */        
             int32 res_;
+            
+            /**
+             * The task result returned to the joining thread.
+             */
+            int32 result_;
+            
+            /**
+             * The priority given to the OS process.
+             */
+            int32 priority_;
     
             /**
              * Current status.
@@ -263,6 +464,60 @@ namespace local
              */
             SchedulerThread* this_;       
             
+            #ifdef SYSTEM_STACK_WATERMARK
+            /**
+             * The pattern of painted stack words.
+             */
+            static const uint32 STACK_PATTERN = 0x5AA5C33Cu;
+            
+            /**
+             * The number of bytes below the painting function which are not painted.
+             */
+            static const size_t STACK_MARGIN = 0x100;
+            
+            /**
+             * The address after the stack, or zero if the stack is not painted.
+             */
+            size_t stackTop_;
+            
+            /**
+             * The lowest painted stack word.
+             */
+            volatile uint32* stackLow_;
+            
+            /**
+             * The word after the highest painted stack word.
+             */
+            volatile uint32* stackHigh_;
+            
+            /**
+             * The stack usage of the dead thread.
+             */
+            int32 stackUsage_;
+            #endif // SYSTEM_STACK_WATERMARK
+            
+            #ifdef SYSTEM_THREAD_STATISTICS
+            /**
+             * The time of starting the thread task.
+             */
+            int64 startTime_;
+            
+            /**
+             * The time of blocking on resources.
+             */
+            int64 blocked_;
+            
+            /**
+             * The time of sleeping.
+             */
+            int64 sleeping_;
+            
+            /**
+             * The number of voluntary switches.
+             */
+            uint32 switches_;
+            #endif // SYSTEM_THREAD_STATISTICS
+            
         };
     }
 }
@@ -11,7 +11,11 @@
 #include "os.h"
 #include "system.Object.hpp"
 #include "api.Semaphore.hpp"
-#include "system.Interrupt.hpp"
+#include "system.CriticalSection.hpp"
+#include "system.Trace.hpp"
+#include "system.Scheduler.hpp"
+#include "system.Clock.hpp"
+#include "system.Coroutine.hpp"
 
 namespace local
 {
@@ -21,6 +25,8 @@ namespace local
         {
             typedef system::Semaphore Self;
             typedef system::Object    Parent;
+            
+            friend class system::Coroutine;
     
         public:
     
@@ -30,8 +36,24 @@ namespace local
              * @param permits the initial number of permits available.   
              */      
             Semaphore(int32 permits) : Parent(),
-                res_           (RES_VOID){
-                bool const isConstructed = construct(permits);
+                res_           (RES_VOID),
+                coroutines_    (0){
+                bool const isConstructed = construct(permits, NULL);
+                setConstructed( isConstructed );                
+            }   
+            
+            /** 
+             * Constructor of a named semaphore.
+             *
+             * The semaphore is shared by all modules which construct it with the name.
+             *
+             * @param permits the initial number of permits available if the semaphore does not exist.
+             * @param name    the semaphore name.
+             */      
+            Semaphore(int32 permits, const char* name) : Parent(),
+                res_           (RES_VOID),
+                coroutines_    (0){
+                bool const isConstructed = name != NULL ? construct(permits, name) : false;
                 setConstructed( isConstructed );                
             }   
     
@@ -56,6 +78,24 @@ namespace local
                 return Parent::isConstructed();
             }        
     
+            /**
+             * Acquires one permit from this semaphore if it is available during a timeout.
+             *
+             * @param millis a timeout in milliseconds, or zero for a try without waiting.
+             * @return true if the semaphore is acquired successfully.
+             */  
+            bool tryAcquire(int64 millis)
+            {
+                if( not Self::isConstructed() ) return false;
+                if(millis < 0) return false;
+                bool const isAcquired = lockResource( static_cast<uint32>(millis) );
+                if(isAcquired)
+                {
+                    Trace::record(Trace::SEMAPHORE_ACQUIRE, res_);
+                }
+                return isAcquired;
+            }
+            
             /**
              * Acquires one permit from this semaphore.
              *
@@ -64,26 +104,42 @@ namespace local
             virtual bool acquire()
             {
                 if( not Self::isConstructed() ) return false;        
-                return sem_lock(res_, SEM_INFINITY) == SEM_OK ? true : false;
+                Trace::record(Trace::SEMAPHORE_WAIT, res_);
+                bool const isAcquired = lockResource(SEM_INFINITY);
+                if(isAcquired)
+                {
+                    Trace::record(Trace::SEMAPHORE_ACQUIRE, res_);
+                }
+                return isAcquired;
             }        
     
             /**
              * Acquires the given number of permits from this semaphore.
              *
+             * The permits are acquired one at a time, and the interrupts 
+             * are not disabled while the caller is blocked.
+             *
              * @param permits the number of permits to acquire.
              * @return true if the semaphore is acquired successfully.
              */  
             virtual bool acquire(int32 permits)
             {
                 if( not Self::isConstructed() ) return false;
-                uint32 error = SEM_OK;
-                bool is = Interrupt::disableAll();
+                bool isAcquired = true;
+                Trace::record(Trace::SEMAPHORE_WAIT, res_);
+                // The permits are acquired one by one, as a blocked thread cannot keep the interrupts disabled
                 for(int32 i=0; i<permits; i++)
                 {
-                    error |= sem_lock(res_, SEM_INFINITY);
+                    if( not lockResource(SEM_INFINITY) )
+                    {
+                        isAcquired = false;
+                    }
                 }
-                Interrupt::enableAll(is);
-                return error == SEM_OK ? true : false;
+                if(isAcquired)
+                {
+                    Trace::record(Trace::SEMAPHORE_ACQUIRE, res_);
+                }
+                return isAcquired;
             }
     
             /**
@@ -92,7 +148,12 @@ namespace local
             virtual void release()
             {
                 if( not Self::isConstructed() ) return;        
+                Trace::record(Trace::SEMAPHORE_RELEASE, res_);
                 sem_unlock(res_);
+                if(coroutines_ != 0)
+                {
+                    Coroutine::notifyAll();
+                }
             } 
     
             /**
@@ -103,12 +164,17 @@ namespace local
             virtual void release(int32 permits)
             {
                 if( not Self::isConstructed() ) return;
-                bool is = Interrupt::disableAll();
+                Trace::record(Trace::SEMAPHORE_RELEASE, res_);
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Semaphore::release");
+                CriticalSection const cs(site);
                 for(int32 i=0; i<permits; i++)
                 {
                     sem_unlock(res_);
                 }
-                Interrupt::enableAll(is);
+                if(coroutines_ != 0)
+                {
+                    Coroutine::notifyAll();
+                }
             }         
     
             /**
@@ -139,16 +205,39 @@ namespace local
     
         private:
     
+            /**
+             * Locks the OS semaphore, and accounts the blocking of the current thread.
+             *
+             * @param timeout a timeout in milliseconds, zero for a try without waiting, or SEM_INFINITY.
+             * @return true if the OS semaphore is locked successfully.
+             */
+            bool lockResource(uint32 const timeout)
+            {
+                #ifdef SYSTEM_THREAD_STATISTICS
+                // Only the locking which has to wait switches the thread
+                if(timeout != 0)
+                {
+                    if(sem_lock(res_, 0) == SEM_OK) return true;
+                    int64 const time = Clock::getTime();
+                    bool const isLocked = sem_lock(res_, timeout) == SEM_OK ? true : false;
+                    Scheduler::recordBlocking(Clock::getTime() - time);
+                    return isLocked;
+                }
+                #endif
+                return sem_lock(res_, timeout) == SEM_OK ? true : false;
+            }
+            
             /**
              * Constructor.
              *
              * @param permits the initial number of permits available.            
+             * @param name    the semaphore name, or NULL.
              * @return true if object has been constructed successfully.     
              */    
-            bool construct(int32 permits)
+            bool construct(int32 permits, const char* name)
             {
                 if( not Self::isConstructed() ) return false;
-                res_ = sem_alloc(permits, NULL);
+                res_ = sem_alloc(permits, name);
                 return res_ == RES_VOID ? false : true;
             }
             
@@ -171,6 +260,11 @@ namespace local
              * The porting OS resource.
              */
             uint32 res_;
+            
+            /**
+             * The number of coroutines waiting for a permit.
+             */
+            volatile int32 coroutines_;
     
         };  
     }
@@ -0,0 +1,171 @@
+/** 
+ * Static system calls.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_SYSCALL_HPP_
+#define SYSTEM_SYSCALL_HPP_
+
+#include "system.System.hpp"
+#include "system.Allocator.hpp"
+#include "system.Clock.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Static system calls.
+         *
+         * The calls of frequently used system functions are selected at compile time
+         * by the system class. Syscall<api::System> calls the virtual interface
+         * of any system, and Syscall<system::System> calls this system directly, 
+         * so that the calls might be inlined.
+         *
+         * @param T a system class.
+         */
+        template <class T>
+        class Syscall;
+        
+        /**
+         * Static system calls of any system.
+         */
+        template <>
+        class Syscall<api::System>
+        {
+        
+        public:
+        
+            /**
+             * Allocates memory.
+             *
+             * @param size a number of bytes to allocate.
+             * @return allocated memory address or a null pointer.
+             */
+            static void* allocate(size_t const size)
+            {
+                return System::call().getHeap().allocate(size, NULL);
+            }
+            
+            /**
+             * Frees an allocated memory.
+             *
+             * @param ptr an address of allocated memory block or a null pointer.
+             */
+            static void free(void* const ptr)
+            {
+                System::call().getHeap().free(ptr);
+            }
+            
+            /**
+             * Returns running time of the operating system.
+             *
+             * @return time in nanoseconds.
+             */
+            static int64 getTime()
+            {
+                return System::call().getTime();
+            }
+            
+            /**
+             * Returns currently executing thread.
+             *
+             * @return the executing thread.
+             */
+            static api::Thread& getCurrentThread()
+            {
+                return System::call().getScheduler().getCurrentThread();
+            }
+            
+            /**
+             * Yields to next thread.
+             */
+            static void yield()
+            {
+                System::call().getScheduler().yield();
+            }
+        
+        private:
+        
+            /**
+             * Constructor.
+             */
+            Syscall();
+        
+        };
+        
+        /**
+         * Static system calls of this system.
+         */
+        template <>
+        class Syscall<System>
+        {
+        
+        public:
+        
+            /**
+             * Allocates memory.
+             *
+             * @param size a number of bytes to allocate.
+             * @return allocated memory address or a null pointer.
+             */
+            static void* allocate(size_t const size)
+            {
+                return Allocator::allocate(size);
+            }
+            
+            /**
+             * Frees an allocated memory.
+             *
+             * @param ptr an address of allocated memory block or a null pointer.
+             */
+            static void free(void* const ptr)
+            {
+                Allocator::free(ptr);
+            }
+            
+            /**
+             * Returns running time of the operating system.
+             *
+             * @return time in nanoseconds.
+             */
+            static int64 getTime()
+            {
+                return Clock::getTime();
+            }
+            
+            /**
+             * Returns currently executing thread.
+             *
+             * @return the executing thread.
+             */
+            static api::Thread& getCurrentThread()
+            {
+                System& system = static_cast<System&>( System::call() );
+                // The qualified name calls the function without the virtual table
+                return system.scheduler_.Scheduler::getCurrentThread();
+            }
+            
+            /**
+             * Yields to next thread.
+             */
+            static void yield()
+            {
+                System& system = static_cast<System&>( System::call() );
+                // The scheduler accounts the switch of the current thread
+                system.scheduler_.Scheduler::yield();
+            }
+        
+        private:
+        
+            /**
+             * Constructor.
+             */
+            Syscall();
+        
+        };
+    }
+}
+#endif // SYSTEM_SYSCALL_HPP_
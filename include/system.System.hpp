@@ -14,16 +14,22 @@
 #include "system.GlobalInterrupt.hpp"
 #include "system.Runtime.hpp"
 #include "system.Scheduler.hpp"
+#include "system.InterruptService.hpp"
+#include "system.EventGroup.hpp"
 #include "Error.hpp"
 
 namespace local
 {
     namespace system
     {
+        template <class T> class Syscall;
+    
         class System : public system::Object, public api::System
         {
             typedef system::System Self;
             typedef system::Object Parent;
+            
+            friend class system::Syscall<System>;
 
         public:
 
@@ -103,6 +109,25 @@ namespace local
              * @return a new interrupt resource, or NULL if an error has been occurred.
              */
             virtual api::Interrupt* createInterrupt(api::Task& handler, int32 source);
+            
+            /**
+             * Creates a new deferred interrupt resource.
+             *
+             * The handler is executed by the deferred interrupt processing service thread.
+             *
+             * @param handler - user class which implements an interrupt handler interface.
+             * @param source  - available interrupt source number.
+             * @return a new interrupt resource, or NULL if an error has been occurred.
+             */
+            api::Interrupt* createDeferredInterrupt(api::Task& handler, int32 source);
+            
+            /**
+             * Creates a new event group resource.
+             *
+             * @param flags - the initial value of the event flags.
+             * @return a new event group resource, or NULL if an error has been occurred.
+             */
+            EventGroup* createEventGroup(uint32 flags);
 
             /**
              * Terminates the operating system execution.
@@ -198,6 +223,11 @@ namespace local
              * The operating system scheduler.
              */
             mutable system::Scheduler scheduler_;
+            
+            /**
+             * The operating system deferred interrupt processing service.
+             */
+            system::InterruptService service_;
 
         };
     }
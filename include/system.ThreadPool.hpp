@@ -0,0 +1,358 @@
+/** 
+ * Pool of persistent worker threads for data-parallel loops.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_THREAD_POOL_HPP_
+#define SYSTEM_THREAD_POOL_HPP_
+
+#include "system.Object.hpp"
+#include "api.Task.hpp"
+#include "api.Scheduler.hpp"
+#include "system.Mutex.hpp"
+#include "system.Barrier.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class ThreadPool : public system::Object, public api::Task
+        {
+            typedef system::ThreadPool Self;
+            typedef system::Object     Parent;
+        
+        public:
+        
+            /**
+             * The maximum number of threads executing a loop including the calling thread.
+             */
+            static const int32 THREADS_NUMBER = 16;
+            
+            /** 
+             * Constructor.
+             *
+             * @param scheduler the scheduler which creates worker threads.
+             * @param workers   the number of worker threads, which is less than THREADS_NUMBER.
+             */     
+            ThreadPool(api::Scheduler& scheduler, int32 workers);
+            
+            /** 
+             * Destructor.
+             */
+            virtual ~ThreadPool();
+            
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */    
+            virtual bool isConstructed() const;
+            
+            /**
+             * Executes chunks of loops in a worker thread.
+             *
+             * @return zero, or error code if an error has been occurred.
+             */        
+            virtual int32 start();
+            
+            /**
+             * Returns size of stack.
+             *
+             * @return stack size in bytes.
+             */
+            virtual int32 getStackSize() const;
+            
+            /**
+             * Returns the number of threads executing a loop.
+             *
+             * @return the number of worker threads plus the calling thread.
+             */
+            int32 getThreadsNumber() const;
+            
+            /**
+             * Executes a loop over an index range in parallel.
+             *
+             * The range is split into chunks, which are executed by the workers and 
+             * the calling thread as the body(int32 begin, int32 end) calls. 
+             * The function must not be called by the workers of this pool.
+             *
+             * @param begin the first index of the range.
+             * @param end   the index next to the last index of the range.
+             * @param body  a function object executing the indexes of a chunk.
+             * @param grain the minimal number of indexes in a chunk, or zero for choosing it by the pool.
+             * @return true if the loop has been executed.
+             */
+            template <class F>
+            bool parallelFor(int32 const begin, int32 const end, F& body, int32 const grain = 0)
+            {
+                ForJob<F> job(body);
+                return execute(job, begin, end, grain);
+            }
+            
+            /**
+             * Reduces an index range in parallel.
+             *
+             * Each thread accumulates its chunks into its own value by the body(int32 begin, int32 end, T& value) 
+             * calls, and the values are combined by the combine(const T& value1, const T& value2) calls. 
+             * The combining must be associative and commutative, as the chunks come to the threads in any order. 
+             * The function must not be called by the workers of this pool.
+             *
+             * @param begin    the first index of the range.
+             * @param end      the index next to the last index of the range.
+             * @param identity the value which is not changed by combining with another value.
+             * @param body     a function object accumulating the indexes of a chunk.
+             * @param combine  a function object returning two values combined.
+             * @param result   the reduced value.
+             * @param grain    the minimal number of indexes in a chunk, or zero for choosing it by the pool.
+             * @return true if the range has been reduced.
+             */
+            template <class T, class F, class C>
+            bool parallelReduce(int32 const begin, int32 const end, const T& identity, F& body, C& combine, T& result, int32 const grain = 0)
+            {
+                ReduceJob<T,F> job(body, identity);
+                if( not execute(job, begin, end, grain) ) return false;
+                result = identity;
+                for(int32 i=0; i<threadsNumber_; i++)
+                {
+                    result = combine(result, job.value[i]);
+                }
+                return true;
+            }
+            
+        private:
+        
+            /**
+             * Loop executed by the pool threads.
+             */
+            class Job
+            {
+            
+            public:
+            
+                /**
+                 * Destructor.
+                 */
+                virtual ~Job(){}
+                
+                /**
+                 * Executes a chunk.
+                 *
+                 * @param begin  the first index of the chunk.
+                 * @param end    the index next to the last index of the chunk.
+                 * @param thread the pool thread index.
+                 */
+                virtual void execute(int32 begin, int32 end, int32 thread) = 0;
+            
+            };
+            
+            /**
+             * Parallel loop.
+             */
+            template <class F>
+            class ForJob : public Job
+            {
+            
+            public:
+            
+                /**
+                 * Constructor.
+                 *
+                 * @param body a function object executing the indexes of a chunk.
+                 */
+                ForJob(F& body) :
+                    body_ (body){
+                }
+                
+                /**
+                 * Executes a chunk.
+                 *
+                 * @param begin  the first index of the chunk.
+                 * @param end    the index next to the last index of the chunk.
+                 * @param thread the pool thread index.
+                 */
+                virtual void execute(int32 const begin, int32 const end, int32 const thread)
+                {
+                    body_(begin, end);
+                }
+            
+            private:
+            
+                /**
+                 * The function object.
+                 */
+                F& body_;
+            
+            };
+            
+            /**
+             * Parallel reduction.
+             */
+            template <class T, class F>
+            class ReduceJob : public Job
+            {
+            
+            public:
+            
+                /**
+                 * Constructor.
+                 *
+                 * @param body     a function object accumulating the indexes of a chunk.
+                 * @param identity the initial value of each thread.
+                 */
+                ReduceJob(F& body, const T& identity) :
+                    body_ (body){
+                    for(int32 i=0; i<THREADS_NUMBER; i++)
+                    {
+                        value[i] = identity;
+                    }
+                }
+                
+                /**
+                 * Executes a chunk.
+                 *
+                 * @param begin  the first index of the chunk.
+                 * @param end    the index next to the last index of the chunk.
+                 * @param thread the pool thread index.
+                 */
+                virtual void execute(int32 const begin, int32 const end, int32 const thread)
+                {
+                    // The chunk is accumulated to a stack value, as the adjacent values share cache lines
+                    T local = value[thread];
+                    body_(begin, end, local);
+                    value[thread] = local;
+                }
+                
+                /**
+                 * The values accumulated by the pool threads.
+                 */
+                T value[THREADS_NUMBER];
+            
+            private:
+            
+                /**
+                 * The function object.
+                 */
+                F& body_;
+            
+            };
+            
+            /**
+             * Constructor.
+             *
+             * @param scheduler the scheduler which creates worker threads.
+             * @return true if object has been constructed successfully.
+             */
+            bool construct(api::Scheduler& scheduler);
+            
+            /**
+             * Executes a job over an index range by all pool threads.
+             *
+             * @param job   the job.
+             * @param begin the first index of the range.
+             * @param end   the index next to the last index of the range.
+             * @param grain the minimal number of indexes in a chunk, or zero.
+             * @return true if the job has been executed.
+             */
+            bool execute(Job& job, int32 begin, int32 end, int32 grain);
+            
+            /**
+             * Executes chunks of the current job until the range is over.
+             *
+             * @param thread the pool thread index.
+             */
+            void executeChunks(int32 thread);
+            
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            ThreadPool(const ThreadPool& obj);
+          
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.     
+             */
+            ThreadPool& operator =(const ThreadPool& obj);
+            
+            /**
+             * The worker thread stack size in bytes.
+             */
+            static const int32 STACK_SIZE = 0x2000;
+            
+            /**
+             * The number of chunks each thread gets from the remaining range at most.
+             *
+             * Chunks become smaller to the end of the range, which balances the threads 
+             * executing chunks of different costs.
+             */
+            static const int32 CHUNKS_PER_THREAD = 2;
+            
+            /**
+             * The number of threads executing a loop.
+             */
+            int32 threadsNumber_;
+            
+            /**
+             * The number of workers which have taken their indexes.
+             */
+            int32 started_;
+            
+            /**
+             * The number of workers which have been executed.
+             */
+            int32 executed_;
+            
+            /**
+             * The current job.
+             */
+            Job* job_;
+            
+            /**
+             * The next index of the range of the current job.
+             */
+            int32 next_;
+            
+            /**
+             * The end of the range of the current job.
+             */
+            int32 end_;
+            
+            /**
+             * The minimal number of indexes in a chunk of the current job.
+             */
+            int32 grain_;
+            
+            /**
+             * The pool is being destroyed.
+             */
+            volatile bool isStopping_;
+            
+            /**
+             * The mutex of the threads calling the loops.
+             */
+            Mutex mutex_;
+            
+            /**
+             * The barrier of starting a job.
+             */
+            Barrier start_;
+            
+            /**
+             * The barrier of completing a job.
+             */
+            Barrier complete_;
+            
+            /**
+             * The worker threads.
+             */
+            api::Thread* thread_[THREADS_NUMBER - 1];
+        
+        };
+    }
+}
+#endif // SYSTEM_THREAD_POOL_HPP_
@@ -0,0 +1,199 @@
+/** 
+ * Binary trace of kernel events.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_TRACE_HPP_
+#define SYSTEM_TRACE_HPP_
+
+#include "Types.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class Trace
+        {
+        
+        public:
+        
+            /**
+             * Types of events.
+             */
+            enum Type
+            {
+                /**
+                 * A thread has been created, the argument is the thread identifier.
+                 */
+                THREAD_CREATE = 0,
+                
+                /**
+                 * A thread has exited, the argument is the thread identifier.
+                 */
+                THREAD_EXIT = 1,
+                
+                /**
+                 * A mutex is being locked, the argument is the mutex resource.
+                 */
+                MUTEX_WAIT = 2,
+                
+                /**
+                 * A mutex has been locked, the argument is the mutex resource.
+                 */
+                MUTEX_LOCK = 3,
+                
+                /**
+                 * A mutex has been unlocked, the argument is the mutex resource.
+                 */
+                MUTEX_UNLOCK = 4,
+                
+                /**
+                 * A semaphore is being acquired, the argument is the semaphore resource.
+                 */
+                SEMAPHORE_WAIT = 5,
+                
+                /**
+                 * A semaphore has been acquired, the argument is the semaphore resource.
+                 */
+                SEMAPHORE_ACQUIRE = 6,
+                
+                /**
+                 * A semaphore has been released, the argument is the semaphore resource.
+                 */
+                SEMAPHORE_RELEASE = 7,
+                
+                /**
+                 * An interrupt handler has been entered, the argument is the vector.
+                 */
+                INTERRUPT_ENTER = 8,
+                
+                /**
+                 * An interrupt handler has been exited, the argument is the vector.
+                 */
+                INTERRUPT_EXIT = 9,
+                
+                /**
+                 * Memory has been allocated, the argument is the lower part of the address, or zero if no memory is available.
+                 */
+                ALLOCATE = 10,
+                
+                /**
+                 * Memory has been freed, the argument is the lower part of the address.
+                 */
+                FREE = 11
+            };
+        
+            /**
+             * An event.
+             *
+             * The event is 16 bytes, and it is stored in the native byte order.
+             */
+            struct Event
+            {
+                /**
+                 * The time of the event in nanoseconds.
+                 */
+                int64 time;
+                
+                /**
+                 * The event argument.
+                 */
+                uint32 argument;
+                
+                /**
+                 * The event type.
+                 */
+                uint16 type;
+                
+                /**
+                 * The identifier of the OS thread, which has generated the event.
+                 */
+                int16 thread;
+            };
+            
+            /**
+             * The number of events of the trace buffer.
+             */
+            static const int32 EVENTS_NUMBER = 4096;
+            
+            /**
+             * Records an event.
+             *
+             * The events are recorded if the SYSTEM_TRACE macro is defined.
+             * The trace buffer is a ring, so the oldest events are overwritten.
+             *
+             * @param type     an event type.
+             * @param argument an event argument.
+             */
+            static void record(Type type, uint32 argument)
+            {
+                #ifdef SYSTEM_TRACE
+                write(type, argument);
+                #else
+                static_cast<void>(type);
+                static_cast<void>(argument);
+                #endif
+            }
+            
+            /**
+             * Copies the recorded events.
+             *
+             * The events are copied in batches with the interrupts disabled for one batch at a time,
+             * and the events overwritten while the trace is being copied are skipped.
+             *
+             * @param events a buffer for copying the events from the oldest to.
+             * @param number the number of events the buffer can contain.
+             * @return the number of copied events.
+             */
+            static int32 read(Event* events, int32 number);
+            
+            /**
+             * Returns the number of overwritten events.
+             *
+             * @return the number of lost events.
+             */
+            static uint32 getLost();
+            
+            /**
+             * Removes all recorded events.
+             */
+            static void reset();
+            
+        private:
+        
+            #ifdef SYSTEM_TRACE
+            /**
+             * Writes an event to the trace buffer.
+             *
+             * @param type     an event type.
+             * @param argument an event argument.
+             */
+            static void write(Type type, uint32 argument);
+            
+            /**
+             * The number of events copied with the interrupts disabled.
+             */
+            static const uint32 READ_BATCH = 64;
+            
+            /**
+             * The trace buffer.
+             */
+            static Event events_[EVENTS_NUMBER];
+            
+            /**
+             * The number of written events.
+             */
+            static uint32 count_;
+            #endif // SYSTEM_TRACE
+            
+            /**
+             * Constructor.
+             */
+            Trace();
+        
+        };
+    }
+}
+#endif // SYSTEM_TRACE_HPP_
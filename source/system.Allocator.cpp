@@ -6,6 +6,8 @@
  * @license   http://embedded.team/license/
  */
 #include "system.Allocator.hpp"
+#include "system.CriticalSection.hpp"
+#include "system.Trace.hpp"
 #include "os.h"
 
 namespace local
@@ -20,7 +22,33 @@ namespace local
          */    
         void* Allocator::allocate(size_t const size)
         {
-            return heap_alloc(NULL, size, HEAP_ALIGN_8);
+            size_t const chunkSize = toChunkSize(size);
+            Chunk* chunk = NULL;
+            if(chunkSize > DIRECT_SIZE)
+            {
+                chunk = allocateDirect(chunkSize);
+            }
+            else if(chunkSize != 0)
+            {
+                {
+                    static CriticalSection::Site site = CRITICAL_SECTION_SITE("Allocator::allocate");
+                    CriticalSection const cs(site);
+                    chunk = allocateChunk(chunkSize);
+                }
+                // The operating system heap is called out of the critical sections
+                Arena* const arena = chunk == NULL ? createArena() : NULL;
+                if(arena != NULL)
+                {
+                    static CriticalSection::Site site = CRITICAL_SECTION_SITE("Allocator::allocate.arena");
+                    CriticalSection const cs(site);
+                    addArena(arena);
+                    chunk = allocateChunk(chunkSize);
+                }
+            }
+            void* const addr = chunk != NULL ? reinterpret_cast<uint8*>(chunk) + sizeof(Chunk) : NULL;
+            // The address matches the allocation with the freeing in the trace
+            Trace::record(Trace::ALLOCATE, static_cast<uint32>( reinterpret_cast<size_t>(addr) ));
+            return addr;
         }
         
         /**
@@ -30,8 +58,501 @@ namespace local
          */      
         void Allocator::free(void* const ptr)
         {
-            heap_free(NULL, ptr);
+            Trace::record(Trace::FREE, static_cast<uint32>( reinterpret_cast<size_t>(ptr) ));
+            if(ptr == NULL) return;
+            Chunk* const chunk = reinterpret_cast<Chunk*>( reinterpret_cast<uint8*>(ptr) - sizeof(Chunk) );
+            void* memory = chunk;
+            if( not isDirect(chunk) )
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Allocator::free");
+                CriticalSection const cs(site);
+                memory = freeChunk(chunk);
+            }
+            // A direct block or an empty arena is returned out of the critical section
+            if(memory != NULL)
+            {
+                heap_free(NULL, memory);
+            }
         }
         
+        /**
+         * Changes the size of an allocated memory.
+         *
+         * @param ptr  address of allocated memory block, or a null pointer for allocating.
+         * @param size number of bytes of the resized memory.
+         * @return resized memory address, or a null pointer if the memory is not resized.
+         */
+        void* Allocator::reallocate(void* const ptr, size_t const size)
+        {
+            if(ptr == NULL) return allocate(size);
+            size_t const chunkSize = toChunkSize(size);
+            if(chunkSize == 0) return NULL;
+            Chunk* const chunk = reinterpret_cast<Chunk*>( reinterpret_cast<uint8*>(ptr) - sizeof(Chunk) );
+            size_t current;
+            if( isDirect(chunk) )
+            {
+                current = getSize(chunk);
+                // A direct block is kept, unless it is grown or shrunk to a half
+                if(chunkSize <= current && chunkSize > current / 2) return ptr;
+            }
+            else
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Allocator::reallocate");
+                CriticalSection const cs(site);
+                current = getSize(chunk);
+                // Take the following free chunk if the memory is grown
+                Chunk* const next = getNext(chunk);
+                if(chunkSize > current && not isUsed(next) && current + getSize(next) >= chunkSize)
+                {
+                    unlink( static_cast<FreeChunk*>(next) );
+                    current += getSize(next);
+                    chunk->size = current | USED;
+                    getNext(chunk)->previous = current;
+                }
+                if(chunkSize <= current)
+                {
+                    splitChunk(chunk, chunkSize);
+                    return ptr;
+                }
+            }
+            // A grown memory is given more room for growing in place next time
+            size_t const room = chunkSize > current ? size + size / 4 : size;
+            void* const addr = allocate(room >= size ? room : size);
+            if(addr == NULL) return NULL;
+            // The payloads are aligned, and their sizes are multiple of the alignment
+            size_t* const dst = reinterpret_cast<size_t*>(addr);
+            const size_t* const src = reinterpret_cast<const size_t*>(ptr);
+            size_t const words = ( (chunkSize < current ? chunkSize : current) - sizeof(Chunk) ) / sizeof(size_t);
+            for(size_t i=0; i<words; i++)
+            {
+                dst[i] = src[i];
+            }
+            free(ptr);
+            return addr;
+        }
+        
+        /**
+         * Walks the arenas and collects their free space.
+         *
+         * @param space the free space.
+         */
+        void Allocator::getFreeSpace(FreeSpace& space)
+        {
+            space.arenas = 0;
+            space.size = 0;
+            space.used = 0;
+            space.free = 0;
+            space.largest = 0;
+            space.blocks = 0;
+            for(int32 i=0; i<CLASSES_NUMBER; i++)
+            {
+                space.classes[i] = 0;
+            }
+            // The arena is found by its index again, as the next arena might be returned between the sections
+            for(uint32 index=0; ; index++)
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Allocator::getFreeSpace");
+                CriticalSection const cs(site);
+                Arena* arena = arenas_;
+                for(uint32 i=0; i<index && arena != NULL; i++)
+                {
+                    arena = arena->next;
+                }
+                if(arena == NULL) break;
+                space.arenas++;
+                space.size += arena->size;
+                Chunk* chunk = reinterpret_cast<Chunk*>( reinterpret_cast<uint8*>(arena) + ARENA_HEADER );
+                while(getSize(chunk) != 0)
+                {
+                    size_t const size = getSize(chunk) - sizeof(Chunk);
+                    if( isUsed(chunk) )
+                    {
+                        space.used += size;
+                    }
+                    else
+                    {
+                        space.free += size;
+                        space.blocks++;
+                        if(size > space.largest)
+                        {
+                            space.largest = size;
+                        }
+                        int32 sizeClass = 0;
+                        while(sizeClass < CLASSES_NUMBER - 1 && (size >> (sizeClass + 5)) != 0)
+                        {
+                            sizeClass++;
+                        }
+                        space.classes[sizeClass]++;
+                    }
+                    chunk = getNext(chunk);
+                }
+            }
+            if(space.free == 0)
+            {
+                space.fragmentation = 0;
+            }
+            else
+            {
+                uint64 const largest = static_cast<uint64>(space.largest) * 1000;
+                space.fragmentation = 1000 - static_cast<int32>( largest / static_cast<uint64>(space.free) );
+            }
+        }
+        
+        /**
+         * Allocates a chunk of the arenas.
+         *
+         * @param size the chunk size in bytes.
+         * @return the chunk, or NULL if the arenas have no free chunk of the size.
+         */
+        Allocator::Chunk* Allocator::allocateChunk(size_t const size)
+        {
+            int32 bin = getBin(size);
+            FreeChunk* chunk = bins_[bin];
+            // The first chunk of the bin is taken if it fits, as any chunk of the next bins fits
+            if(chunk == NULL || getSize(chunk) < size)
+            {
+                bin = findBin(bin + 1);
+                if(bin < 0) return NULL;
+                chunk = bins_[bin];
+            }
+            unlink(chunk);
+            if( isEmpty(chunk) )
+            {
+                empty_--;
+            }
+            chunk->size |= USED;
+            splitChunk(chunk, size);
+            return chunk;
+        }
+        
+        /**
+         * Frees a chunk, and merges it with the adjacent free chunks.
+         *
+         * @param chunk a used chunk.
+         * @return an empty arena unlinked for returning to the operating system, or NULL.
+         */
+        Allocator::Arena* Allocator::freeChunk(Chunk* chunk)
+        {
+            size_t size = getSize(chunk);
+            Chunk* const next = getNext(chunk);
+            if( not isUsed(next) )
+            {
+                unlink( static_cast<FreeChunk*>(next) );
+                size += getSize(next);
+            }
+            if(chunk->previous != 0)
+            {
+                Chunk* const prev = reinterpret_cast<Chunk*>( reinterpret_cast<uint8*>(chunk) - chunk->previous );
+                if( not isUsed(prev) )
+                {
+                    unlink( static_cast<FreeChunk*>(prev) );
+                    size += getSize(prev);
+                    chunk = prev;
+                }
+            }
+            chunk->size = size;
+            getNext(chunk)->previous = size;
+            // One empty arena is kept for the next allocations, and the others are returned
+            if( isEmpty(chunk) )
+            {
+                if(empty_ != 0)
+                {
+                    Arena* const arena = reinterpret_cast<Arena*>( reinterpret_cast<uint8*>(chunk) - ARENA_HEADER );
+                    if(arena->prev != NULL)
+                    {
+                        arena->prev->next = arena->next;
+                    }
+                    else
+                    {
+                        arenas_ = arena->next;
+                    }
+                    if(arena->next != NULL)
+                    {
+                        arena->next->prev = arena->prev;
+                    }
+                    return arena;
+                }
+                empty_++;
+            }
+            link(chunk);
+            return NULL;
+        }
+        
+        /**
+         * Splits off the tail of a used chunk, and frees the tail.
+         *
+         * @param chunk a used chunk.
+         * @param size  the new chunk size in bytes.
+         */
+        void Allocator::splitChunk(Chunk* const chunk, size_t const size)
+        {
+            size_t const total = getSize(chunk);
+            if(total - size < sizeof(FreeChunk)) return;
+            chunk->size = size | USED;
+            Chunk* const tail = getNext(chunk);
+            tail->size = (total - size) | USED;
+            tail->previous = size;
+            getNext(tail)->previous = total - size;
+            // The tail follows a used chunk, so its arena is not emptied
+            freeChunk(tail);
+        }
+        
+        /**
+         * Requests a new arena from the operating system heap.
+         *
+         * @return the arena, or NULL if no memory is available.
+         */
+        Allocator::Arena* Allocator::createArena()
+        {
+            Arena* const arena = reinterpret_cast<Arena*>( heap_alloc(NULL, ARENA_SIZE, HEAP_ALIGN_8) );
+            if(arena == NULL) return NULL;
+            arena->size = ARENA_SIZE;
+            size_t const chunkSize = (ARENA_SIZE - ARENA_HEADER - sizeof(Chunk)) & ~(ALIGNMENT - 1);
+            Chunk* const chunk = reinterpret_cast<Chunk*>( reinterpret_cast<uint8*>(arena) + ARENA_HEADER );
+            chunk->size = chunkSize;
+            chunk->previous = 0;
+            // The arena end is an empty used chunk, which is never merged
+            Chunk* const end = getNext(chunk);
+            end->size = 0 | USED;
+            end->previous = chunkSize;
+            return arena;
+        }
+        
+        /**
+         * Links a new arena, and its free chunk of the whole arena.
+         *
+         * @param arena an arena.
+         */
+        void Allocator::addArena(Arena* const arena)
+        {
+            arena->prev = NULL;
+            arena->next = arenas_;
+            if(arenas_ != NULL)
+            {
+                arenas_->prev = arena;
+            }
+            arenas_ = arena;
+            link( reinterpret_cast<Chunk*>( reinterpret_cast<uint8*>(arena) + ARENA_HEADER ) );
+            empty_++;
+        }
+        
+        /**
+         * Requests a block directly from the operating system heap.
+         *
+         * @param size the chunk size of the block in bytes.
+         * @return the block chunk, or NULL if no memory is available.
+         */
+        Allocator::Chunk* Allocator::allocateDirect(size_t const size)
+        {
+            // Direct blocks are rounded up, so they have room to grow in place
+            size_t const blockSize = (size + DIRECT_SIZE - 1) & ~(DIRECT_SIZE - 1);
+            if(blockSize < size) return NULL;
+            Chunk* const chunk = reinterpret_cast<Chunk*>( heap_alloc(NULL, blockSize, HEAP_ALIGN_8) );
+            if(chunk == NULL) return NULL;
+            chunk->size = blockSize | USED | DIRECT;
+            chunk->previous = 0;
+            return chunk;
+        }
+        
+        /**
+         * Links a chunk to the free chunks list of its bin.
+         *
+         * @param chunk a chunk.
+         */
+        void Allocator::link(Chunk* const chunk)
+        {
+            FreeChunk* const node = static_cast<FreeChunk*>(chunk);
+            int32 const bin = getBin( getSize(node) );
+            node->prev = NULL;
+            node->next = bins_[bin];
+            if(bins_[bin] != NULL)
+            {
+                bins_[bin]->prev = node;
+            }
+            bins_[bin] = node;
+            map_[bin / WORD_BITS] |= 1u << (bin % WORD_BITS);
+        }
+        
+        /**
+         * Unlinks a chunk from the free chunks list of its bin.
+         *
+         * @param chunk a free chunk.
+         */
+        void Allocator::unlink(FreeChunk* const chunk)
+        {
+            if(chunk->prev != NULL)
+            {
+                chunk->prev->next = chunk->next;
+            }
+            else
+            {
+                int32 const bin = getBin( getSize(chunk) );
+                bins_[bin] = chunk->next;
+                if(chunk->next == NULL)
+                {
+                    map_[bin / WORD_BITS] &= ~(1u << (bin % WORD_BITS));
+                }
+            }
+            if(chunk->next != NULL)
+            {
+                chunk->next->prev = chunk->prev;
+            }
+        }
+        
+        /**
+         * Returns the chunk size of a memory size.
+         *
+         * @param size a memory size in bytes.
+         * @return the chunk size in bytes, or zero if the size is too big.
+         */
+        size_t Allocator::toChunkSize(size_t const size)
+        {
+            size_t const chunkSize = (size + sizeof(Chunk) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+            if(chunkSize < size) return 0;
+            return chunkSize < sizeof(FreeChunk) ? sizeof(FreeChunk) : chunkSize;
+        }
+        
+        /**
+         * Returns the bin of free chunks of a size.
+         *
+         * @param size a chunk size in bytes.
+         * @return the bin index.
+         */
+        int32 Allocator::getBin(size_t const size)
+        {
+            if(size < (1u << EXACT_BITS)) return static_cast<int32>(size / ALIGNMENT);
+            int32 bit = EXACT_BITS;
+            while(bit < WORD_BITS - 1 && (size >> (bit + 1)) != 0)
+            {
+                bit++;
+            }
+            // Each power of two is split by the bits following the highest one
+            int32 const split = static_cast<int32>( (size >> (bit - SPLIT_BITS)) & ((1u << SPLIT_BITS) - 1u) );
+            return EXACT_BINS + ((bit - EXACT_BITS) << SPLIT_BITS) + split;
+        }
+        
+        /**
+         * Returns the first bin which has free chunks.
+         *
+         * @param bin the bin index the search is started from.
+         * @return the bin index, or -1 if all the bins from the given one are empty.
+         */
+        int32 Allocator::findBin(int32 const bin)
+        {
+            if(bin >= BINS_NUMBER) return -1;
+            int32 word = bin / WORD_BITS;
+            uint32 bits = map_[word] & ~getMask(bin % WORD_BITS);
+            while(bits == 0u)
+            {
+                word++;
+                if(word == WORDS_NUMBER) return -1;
+                bits = map_[word];
+            }
+            return word * WORD_BITS + getLowestBit(bits);
+        }
+        
+        /**
+         * Returns the next chunk of an arena.
+         *
+         * @param chunk a chunk.
+         * @return the next chunk.
+         */
+        Allocator::Chunk* Allocator::getNext(Chunk* const chunk)
+        {
+            return reinterpret_cast<Chunk*>( reinterpret_cast<uint8*>(chunk) + getSize(chunk) );
+        }
+        
+        /**
+         * Returns the chunk size.
+         *
+         * @param chunk a chunk.
+         * @return the chunk size in bytes.
+         */
+        size_t Allocator::getSize(const Chunk* const chunk)
+        {
+            return chunk->size & ~(USED | DIRECT);
+        }
+        
+        /**
+         * Tests if a chunk is used.
+         *
+         * @param chunk a chunk.
+         * @return true if the chunk is used.
+         */
+        bool Allocator::isUsed(const Chunk* const chunk)
+        {
+            return (chunk->size & USED) != 0 ? true : false;
+        }
+        
+        /**
+         * Tests if a chunk is a block requested directly from the operating system heap.
+         *
+         * @param chunk a used chunk.
+         * @return true if the chunk is a direct block.
+         */
+        bool Allocator::isDirect(const Chunk* const chunk)
+        {
+            return (chunk->size & DIRECT) != 0 ? true : false;
+        }
+        
+        /**
+         * Tests if a free chunk takes the whole arena.
+         *
+         * @param chunk a free chunk.
+         * @return true if the arena of the chunk is empty.
+         */
+        bool Allocator::isEmpty(Chunk* const chunk)
+        {
+            return chunk->previous == 0 && getSize( getNext(chunk) ) == 0;
+        }
+        
+        /**
+         * Returns a mask of the lowest bits of a word.
+         *
+         * @param count the number of the lowest bits to be set.
+         * @return the mask.
+         */
+        uint32 Allocator::getMask(int32 const count)
+        {
+            return count < WORD_BITS ? (1u << count) - 1u : 0xFFFFFFFFu;
+        }
+        
+        /**
+         * Returns a number of the lowest set bit of a word.
+         *
+         * @param word a non-zero word.
+         * @return the bit number.
+         */
+        int32 Allocator::getLowestBit(uint32 const word)
+        {
+            // The multiplication by a de Bruijn sequence of the isolated bit
+            static const int32 bits[WORD_BITS] = {
+                 0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8, 
+                31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+            };
+            uint32 const lowest = word & (~word + 1u);
+            return bits[(lowest * 0x077CB531u) >> 27];
+        }
+        
+        /**
+         * The arenas.
+         */
+        Allocator::Arena* Allocator::arenas_ = NULL;
+        
+        /**
+         * The number of empty arenas.
+         */
+        uint32 Allocator::empty_ = 0;
+        
+        /**
+         * The free chunks lists of the bins.
+         */
+        Allocator::FreeChunk* Allocator::bins_[Allocator::BINS_NUMBER] = { NULL };
+        
+        /**
+         * The bitmap of bins, which have free chunks.
+         */
+        uint32 Allocator::map_[Allocator::WORDS_NUMBER] = { 0 };
+        
     }
 }
@@ -0,0 +1,140 @@
+/** 
+ * Reusable barrier of threads.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Barrier.hpp"
+#include "system.CriticalSection.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /** 
+         * Constructor.
+         *
+         * @param parties the number of threads, which must arrive to pass the barrier.
+         */
+        Barrier::Barrier(int32 const parties) : Parent(),
+            parties_ (parties),
+            count_   (parties),
+            phase_   (0),
+            gate0_   (0),
+            gate1_   (0){
+            bool const isConstructed = construct();
+            setConstructed( isConstructed );
+        }
+        
+        /** 
+         * Destructor.
+         */
+        Barrier::~Barrier()
+        {
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool Barrier::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Waits until all parties arrive.
+         *
+         * @return true for the last arriving thread, and false for other threads.
+         */
+        bool Barrier::await()
+        {
+            if( not Self::isConstructed() ) return false;
+            uint32 phase;
+            int32 waiting = 0;
+            bool isLast;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Barrier::await");
+                CriticalSection const cs(site);
+                phase = phase_ & 1;
+                count_--;
+                isLast = count_ == 0 ? true : false;
+                if(isLast)
+                {
+                    // The next phase uses the other gate, so it starts at once
+                    count_ = parties_;
+                    phase_++;
+                    waiting = waiting_[phase];
+                    waiting_[phase] = 0;
+                }
+                else
+                {
+                    waiting_[phase]++;
+                }
+            }
+            Semaphore& gate = phase == 0 ? gate0_ : gate1_;
+            if(isLast)
+            {
+                // The OS semaphores have no broadcast, so the permits are released one by one with the interrupts enabled
+                for(int32 i=0; i<waiting; i++)
+                {
+                    gate.release();
+                }
+                return true;
+            }
+            gate.acquire();
+            return false;
+        }
+        
+        /**
+         * Arrives at the barrier without waiting for other parties.
+         *
+         * @return true for the last arriving thread, and false for other threads.
+         */
+        bool Barrier::arrive()
+        {
+            if( not Self::isConstructed() ) return false;
+            uint32 phase;
+            int32 waiting = 0;
+            bool isLast;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Barrier::arrive");
+                CriticalSection const cs(site);
+                phase = phase_ & 1;
+                count_--;
+                isLast = count_ == 0 ? true : false;
+                if(isLast)
+                {
+                    count_ = parties_;
+                    phase_++;
+                    waiting = waiting_[phase];
+                    waiting_[phase] = 0;
+                }
+            }
+            Semaphore& gate = phase == 0 ? gate0_ : gate1_;
+            for(int32 i=0; i<waiting; i++)
+            {
+                gate.release();
+            }
+            return isLast;
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool Barrier::construct()
+        {
+            if( not Self::isConstructed() ) return false;
+            if(parties_ <= 0) return false;
+            if( not gate0_.isConstructed() ) return false;
+            if( not gate1_.isConstructed() ) return false;
+            waiting_[0] = 0;
+            waiting_[1] = 0;
+            return true;
+        }
+    }
+}
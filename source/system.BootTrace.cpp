@@ -0,0 +1,82 @@
+/** 
+ * Boot time trace.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.BootTrace.hpp"
+#include "system.CriticalSection.hpp"
+#include "system.Clock.hpp"
+
+namespace local
+{ 
+    namespace system
+    {
+        /**
+         * Returns the number of marked milestones.
+         *
+         * @return the number of milestones.
+         */
+        int32 BootTrace::getLength()
+        {
+            #ifdef SYSTEM_BOOT_TRACE
+            return length_;
+            #else
+            return 0;
+            #endif
+        }
+        
+        /**
+         * Returns a marked milestone.
+         *
+         * @param index     an index of the milestone in marking order.
+         * @param milestone a milestone for copying to.
+         * @return true if the milestone has been copied.
+         */
+        bool BootTrace::get(int32 const index, Milestone& milestone)
+        {
+            #ifdef SYSTEM_BOOT_TRACE
+            if(index < 0 || index >= length_) return false;
+            milestone = milestones_[index];
+            return true;
+            #else
+            static_cast<void>(index);
+            static_cast<void>(milestone);
+            return false;
+            #endif
+        }
+        
+        #ifdef SYSTEM_BOOT_TRACE
+
+        /**
+         * Records a milestone.
+         *
+         * @param name a constant string of the milestone name.
+         */
+        void BootTrace::record(const char* const name)
+        {
+            // The clock is the one of System::getTime, which is not callable until the system is constructed
+            int64 const time = Clock::getTime();
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("BootTrace::record");
+            CriticalSection const cs(site);
+            if(length_ < MILESTONES_NUMBER)
+            {
+                milestones_[length_].name = name;
+                milestones_[length_].time = time;
+                length_++;
+            }
+        }
+        
+        /**
+         * The marked milestones.
+         */
+        BootTrace::Milestone BootTrace::milestones_[BootTrace::MILESTONES_NUMBER];
+        
+        /**
+         * The number of marked milestones.
+         */
+        int32 BootTrace::length_ = 0;
+        #endif // SYSTEM_BOOT_TRACE
+    }
+}
@@ -0,0 +1,220 @@
+/** 
+ * Pool of fixed-size buffers with reference-counted descriptors.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.BufferPool.hpp"
+#include "system.CriticalSection.hpp"
+#include "system.Allocator.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /** 
+         * Constructor.
+         *
+         * @param size        the size of a block in bytes.
+         * @param number      the number of blocks.
+         * @param descriptors the number of descriptors, which is not less than the number of blocks.
+         */
+        BufferPool::BufferPool(int32 const size, int32 const number, int32 const descriptors) : Parent(),
+            size_        (size),
+            number_      (number),
+            descriptors_ (descriptors),
+            free_        (0),
+            memory_      (NULL),
+            blocks_      (NULL),
+            buffers_     (NULL),
+            freeBlocks_  (NULL),
+            freeBuffers_ (NULL){
+            bool const isConstructed = construct();
+            setConstructed( isConstructed );
+        }
+        
+        /** 
+         * Destructor.
+         */
+        BufferPool::~BufferPool()
+        {
+            Allocator::free(buffers_);
+            Allocator::free(blocks_);
+            Allocator::free(memory_);
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool BufferPool::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Takes a free block.
+         *
+         * @return a descriptor of the whole block, or NULL if no block or descriptor is free.
+         */
+        BufferPool::Buffer* BufferPool::allocate()
+        {
+            if( not Self::isConstructed() ) return NULL;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("BufferPool::allocate");
+            CriticalSection const cs(site);
+            Block* const block = freeBlocks_;
+            if(block == NULL) return NULL;
+            Buffer* const buffer = freeBuffers_;
+            if(buffer == NULL) return NULL;
+            freeBlocks_ = block->next;
+            freeBuffers_ = buffer->next_;
+            free_--;
+            block->references = 1;
+            block->next = NULL;
+            buffer->data_ = block->data;
+            buffer->length_ = size_;
+            buffer->block_ = block;
+            buffer->next_ = NULL;
+            return buffer;
+        }
+        
+        /**
+         * Creates a descriptor of a region of a buffer without copying.
+         *
+         * @param buffer a descriptor of this pool.
+         * @param offset the region offset from the buffer data.
+         * @param length the region length.
+         * @return a new descriptor of the region, or NULL if an error has been occurred,
+         *         or the buffer is released or is not a descriptor of this pool.
+         */
+        BufferPool::Buffer* BufferPool::slice(const Buffer& buffer, int32 const offset, int32 const length)
+        {
+            if( not Self::isConstructed() ) return NULL;
+            if( not isOwn(&buffer) ) return NULL;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("BufferPool::slice");
+            CriticalSection const cs(site);
+            // The descriptor might be released by an interrupt handler until the section
+            if(buffer.block_ == NULL) return NULL;
+            if(offset < 0 || length < 0 || offset > buffer.length_ - length) return NULL;
+            Buffer* const slice = freeBuffers_;
+            if(slice == NULL) return NULL;
+            freeBuffers_ = slice->next_;
+            buffer.block_->references++;
+            slice->data_ = buffer.data_ + offset;
+            slice->length_ = length;
+            slice->block_ = buffer.block_;
+            slice->next_ = NULL;
+            return slice;
+        }
+        
+        /**
+         * Creates a descriptor of a buffer without copying.
+         *
+         * @param buffer a descriptor of this pool.
+         * @return a new descriptor of the same region, or NULL if no descriptor is free.
+         */
+        BufferPool::Buffer* BufferPool::share(const Buffer& buffer)
+        {
+            return slice(buffer, 0, buffer.length_);
+        }
+        
+        /**
+         * Releases a descriptor, and returns its block to the pool if it is not referenced anymore.
+         *
+         * @param buffer a descriptor of this pool, or NULL.
+         */
+        void BufferPool::release(Buffer* const buffer)
+        {
+            if( not Self::isConstructed() ) return;
+            if(buffer == NULL) return;
+            if( not isOwn(buffer) ) return;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("BufferPool::release");
+            CriticalSection const cs(site);
+            Block* const block = buffer->block_;
+            if(block == NULL) return;
+            buffer->data_ = NULL;
+            buffer->length_ = 0;
+            buffer->block_ = NULL;
+            buffer->next_ = freeBuffers_;
+            freeBuffers_ = buffer;
+            block->references--;
+            if(block->references == 0)
+            {
+                block->next = freeBlocks_;
+                freeBlocks_ = block;
+                free_++;
+            }
+        }
+        
+        /**
+         * Returns the size of a block.
+         *
+         * @return the block size in bytes.
+         */
+        int32 BufferPool::getSize() const
+        {
+            return size_;
+        }
+        
+        /**
+         * Returns the number of free blocks.
+         *
+         * @return the number of blocks which might be allocated.
+         */
+        int32 BufferPool::getFree() const
+        {
+            return free_;
+        }
+        
+        /**
+         * Tests if a descriptor belongs to this pool.
+         *
+         * @param buffer a descriptor.
+         * @return true if the descriptor is one of this pool.
+         */
+        bool BufferPool::isOwn(const Buffer* const buffer) const
+        {
+            size_t const addr = reinterpret_cast<size_t>(buffer);
+            size_t const first = reinterpret_cast<size_t>(buffers_);
+            size_t const last = reinterpret_cast<size_t>(buffers_ + descriptors_);
+            if(addr < first || addr >= last) return false;
+            return (addr - first) % sizeof(Buffer) == 0 ? true : false;
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool BufferPool::construct()
+        {
+            if( not Self::isConstructed() ) return false;
+            if(size_ <= 0 || number_ <= 0 || descriptors_ < number_) return false;
+            int32 const stride = (size_ + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+            memory_ = reinterpret_cast<uint8*>( Allocator::allocate( static_cast<size_t>(stride) * static_cast<size_t>(number_) ) );
+            blocks_ = reinterpret_cast<Block*>( Allocator::allocate( sizeof(Block) * static_cast<size_t>(number_) ) );
+            buffers_ = reinterpret_cast<Buffer*>( Allocator::allocate( sizeof(Buffer) * static_cast<size_t>(descriptors_) ) );
+            if(memory_ == NULL || blocks_ == NULL || buffers_ == NULL) return false;
+            // Link the blocks and the descriptors in address order
+            for(int32 i=number_ - 1; i>=0; i--)
+            {
+                blocks_[i].data = memory_ + i * stride;
+                blocks_[i].references = 0;
+                blocks_[i].next = freeBlocks_;
+                freeBlocks_ = &blocks_[i];
+            }
+            for(int32 i=descriptors_ - 1; i>=0; i--)
+            {
+                buffers_[i].data_ = NULL;
+                buffers_[i].length_ = 0;
+                buffers_[i].block_ = NULL;
+                buffers_[i].next_ = freeBuffers_;
+                freeBuffers_ = &buffers_[i];
+            }
+            free_ = number_;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,256 @@
+/** 
+ * Shared memory channel of messages between modules.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Channel.hpp"
+#include "os.h"
+
+#ifdef SYSTEM_CHANNEL
+
+namespace local
+{
+    namespace system
+    {
+        /** 
+         * Constructor.
+         *
+         * @param name the channel name.
+         * @param size the ring buffer size in bytes, which is a power of two.
+         */
+        Channel::Channel(const char* const name, int32 const size) : Parent(),
+            size_     (size),
+            res_      (RES_VOID),
+            header_   (NULL),
+            ring_     (NULL),
+            readable_ (NULL),
+            writable_ (NULL){
+            bool const isConstructed = construct(name);
+            setConstructed( isConstructed );
+        }
+        
+        /** 
+         * Destructor.
+         */
+        Channel::~Channel()
+        {
+            if(header_ != NULL)
+            {
+                add(&header_->sides, -1);
+            }
+            delete readable_;
+            delete writable_;
+            if(res_ != RES_VOID)
+            {
+                shm_free(res_);
+            }
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool Channel::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Writes a message, and waits for free space if the ring buffer is full.
+         *
+         * @param data   the message.
+         * @param length the message length in bytes.
+         * @return true if the message has been written.
+         */
+        bool Channel::write(const void* const data, int32 const length)
+        {
+            if( not Self::isConstructed() ) return false;
+            if(data == NULL || length < 0) return false;
+            uint32 const need = sizeof(uint32) + ( (static_cast<uint32>(length) + ALIGNMENT - 1) & ~(ALIGNMENT - 1) );
+            if(need > static_cast<uint32>(size_)) return false;
+            uint32 const head = header_->head;
+            while(static_cast<uint32>(size_) - (head - header_->tail) < need)
+            {
+                // The reader checks the flag after freeing space, so the flag is tested again
+                header_->isWriting = 1;
+                fence();
+                if(static_cast<uint32>(size_) - (head - header_->tail) >= need)
+                {
+                    header_->isWriting = 0;
+                    break;
+                }
+                if( not writable_->acquire() ) return false;
+            }
+            uint32 const size = static_cast<uint32>(length);
+            copyTo(head, reinterpret_cast<const uint8*>(&size), sizeof(uint32));
+            copyTo(head + sizeof(uint32), reinterpret_cast<const uint8*>(data), length);
+            fence();
+            header_->head = head + need;
+            fence();
+            if(header_->isReading != 0)
+            {
+                header_->isReading = 0;
+                readable_->release();
+            }
+            return true;
+        }
+        
+        /**
+         * Reads a message, and waits for it if the ring buffer is empty.
+         *
+         * @param data the buffer for the message.
+         * @param size the buffer size in bytes.
+         * @return the message length, or -1 if an error has been occurred or the message has been dropped.
+         */
+        int32 Channel::read(void* const data, int32 const size)
+        {
+            if( not Self::isConstructed() ) return -1;
+            if(data == NULL || size < 0) return -1;
+            uint32 const tail = header_->tail;
+            while(header_->head == tail)
+            {
+                // The writer checks the flag after writing, so the flag is tested again
+                header_->isReading = 1;
+                fence();
+                if(header_->head != tail)
+                {
+                    header_->isReading = 0;
+                    break;
+                }
+                if( not readable_->acquire() ) return -1;
+            }
+            fence();
+            uint32 length;
+            copyFrom(tail, reinterpret_cast<uint8*>(&length), sizeof(uint32));
+            // The message which does not fit the buffer is dropped, so the channel is not blocked by it
+            bool const isDropped = length > static_cast<uint32>(size);
+            if( not isDropped )
+            {
+                copyFrom(tail + sizeof(uint32), reinterpret_cast<uint8*>(data), static_cast<int32>(length));
+            }
+            uint32 const need = sizeof(uint32) + ( (length + ALIGNMENT - 1) & ~(ALIGNMENT - 1) );
+            fence();
+            header_->tail = tail + need;
+            fence();
+            if(header_->isWriting != 0)
+            {
+                header_->isWriting = 0;
+                writable_->release();
+            }
+            return isDropped ? -1 : static_cast<int32>(length);
+        }
+        
+        /**
+         * Copies bytes to the ring buffer.
+         *
+         * @param index  the ring buffer index.
+         * @param data   the bytes.
+         * @param length the number of bytes.
+         */
+        void Channel::copyTo(uint32 const index, const uint8* const data, int32 const length)
+        {
+            uint32 const mask = static_cast<uint32>(size_) - 1;
+            for(int32 i=0; i<length; i++)
+            {
+                ring_[(index + i) & mask] = data[i];
+            }
+        }
+        
+        /**
+         * Copies bytes from the ring buffer.
+         *
+         * @param index  the ring buffer index.
+         * @param data   the buffer for the bytes.
+         * @param length the number of bytes.
+         */
+        void Channel::copyFrom(uint32 const index, uint8* const data, int32 const length) const
+        {
+            uint32 const mask = static_cast<uint32>(size_) - 1;
+            for(int32 i=0; i<length; i++)
+            {
+                data[i] = ring_[(index + i) & mask];
+            }
+        }
+        
+        /**
+         * Orders the memory accesses of the modules.
+         */
+        void Channel::fence()
+        {
+            #if defined(__GNUC__)
+            __sync_synchronize();
+            #endif
+        }
+        
+        /**
+         * Adds a value to a shared counter.
+         *
+         * @param counter the counter.
+         * @param value   the value.
+         * @return the counter value before the adding.
+         */
+        uint32 Channel::add(volatile uint32* const counter, int32 const value)
+        {
+            #if defined(__GNUC__)
+            return __sync_fetch_and_add(counter, static_cast<uint32>(value));
+            #else
+            uint32 const previous = *counter;
+            *counter = previous + static_cast<uint32>(value);
+            return previous;
+            #endif
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @param name the channel name.
+         * @return true if object has been constructed successfully.
+         */
+        bool Channel::construct(const char* const name)
+        {
+            if( not Self::isConstructed() ) return false;
+            if(name == NULL) return false;
+            if(size_ < ALIGNMENT || (size_ & (size_ - 1)) != 0) return false;
+            int32 length = 0;
+            while(name[length] != '\0')
+            {
+                if(++length > NAME_LENGTH) return false;
+            }
+            // The names of the region and the semaphores differ by suffixes
+            char buffer[NAME_LENGTH + 4];
+            for(int32 i=0; i<length; i++)
+            {
+                buffer[i] = name[i];
+            }
+            buffer[length + 0] = '.';
+            buffer[length + 1] = 'm';
+            buffer[length + 2] = '\0';
+            res_ = shm_alloc(buffer, sizeof(Header) + static_cast<size_t>(size_));
+            if(res_ == RES_VOID) return false;
+            Header* const header = reinterpret_cast<Header*>( shm_addr(res_) );
+            if(header == NULL) return false;
+            // The first module which opens the channel finds the region of zeros
+            bool const isFirst = add(&header->sides, 1) == 0;
+            header_ = header;
+            ring_ = reinterpret_cast<uint8*>(header_) + sizeof(Header);
+            buffer[length + 1] = 'r';
+            readable_ = new Semaphore(0, buffer);
+            if(readable_ == NULL || not readable_->isConstructed() ) return false;
+            buffer[length + 1] = 'w';
+            writable_ = new Semaphore(0, buffer);
+            if(writable_ == NULL || not writable_->isConstructed() ) return false;
+            // The semaphores outlive the modules, so the permits left by crashed modules are taken
+            if(isFirst)
+            {
+                while( readable_->tryAcquire(0) ){}
+                while( writable_->tryAcquire(0) ){}
+            }
+            return true;
+        }
+    }
+}
+
+#endif // SYSTEM_CHANNEL
@@ -0,0 +1,61 @@
+/** 
+ * Monotonic clock of the operating system.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Clock.hpp"
+#include "system.Interrupt.hpp"
+
+namespace local
+{ 
+    namespace system
+    {
+        /**
+         * Returns the counter frequency.
+         *
+         * @return the number of counter ticks per second.
+         */
+        int64 Clock::getFrequency()
+        {
+            if(scale_ == 0) return 0;
+            return static_cast<int64>( (1000000000ull << 32) / scale_ );
+        }
+        
+        /**
+         * Calibrates the counter by the monotonic time.
+         *
+         * @return true if the counter has been calibrated.
+         */
+        bool Clock::calibrate()
+        {
+            #if defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+            // The interrupts are disabled for sampling both clocks at the same moment
+            bool is = Interrupt::disableAll();
+            int64 const beginTime = getTime();
+            uint64 const beginCounter = getCounter();
+            Interrupt::enableAll(is);
+            int64 endTime;
+            uint64 endCounter;
+            do
+            {
+                is = Interrupt::disableAll();
+                endTime = getTime();
+                endCounter = getCounter();
+                Interrupt::enableAll(is);
+            }
+            while(endTime - beginTime < CALIBRATION_TIME);
+            uint64 const ticks = endCounter - beginCounter;
+            if(ticks == 0) return false;
+            scale_ = ( static_cast<uint64>(endTime - beginTime) << 32 ) / ticks;
+            #endif
+            return true;
+        }
+        
+        /**
+         * The number of nanoseconds per counter tick in 32.32 fixed point format.
+         */
+        uint64 Clock::scale_ = 1ull << 32;
+    }
+}
@@ -0,0 +1,382 @@
+/** 
+ * Scheduler of stackless coroutines.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.CoroutineScheduler.hpp"
+#include "system.CriticalSection.hpp"
+#include "system.Clock.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Constructor.
+         *
+         * @param scheduler the scheduler which creates a carrier thread.
+         */
+        CoroutineScheduler::CoroutineScheduler(api::Scheduler& scheduler) : Parent(),
+            coroutines_ (NULL),
+            added_      (NULL),
+            isStopping_ (false),
+            res_        (RES_VOID),
+            thread_     (NULL),
+            isIdle_     (false),
+            nextIdle_   (NULL){
+            bool const isConstructed = construct(scheduler);
+            setConstructed( isConstructed );
+        }
+        
+        /**
+         * Destructor.
+         */
+        CoroutineScheduler::~CoroutineScheduler()
+        {
+            if(thread_ != NULL)
+            {
+                isStopping_ = true;
+                notify();
+                thread_->join();
+                delete thread_;
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("CoroutineScheduler::~CoroutineScheduler");
+                CriticalSection const cs(site);
+                schedulers_--;
+            }
+            // The coroutines which have not completed can be added to another scheduler
+            detach(coroutines_);
+            detach(added_);
+            if(res_ != RES_VOID)
+            {
+                sem_free(res_);
+            }
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool CoroutineScheduler::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Resumes the coroutines in the carrier thread.
+         *
+         * @return zero, or error code if an error has been occurred.
+         */        
+        int32 CoroutineScheduler::start()
+        {
+            while( not isStopping_ )
+            {
+                // The events which occur while the coroutines are resumed are not missed by the idle carrier
+                uint32 const events = events_;
+                int64 const time = Clock::getTime();
+                int64 wake = 0;
+                // The coroutines being destroyed are not removed until the resumption pass ends
+                mutex_.lock();
+                // Append the added coroutines to the end of the resumption order
+                {
+                    static CriticalSection::Site site = CRITICAL_SECTION_SITE("CoroutineScheduler::start");
+                    CriticalSection const cs(site, CriticalSection::THREADS);
+                    Coroutine** last = &coroutines_;
+                    while(*last != NULL)
+                    {
+                        last = &(*last)->next_;
+                    }
+                    *last = added_;
+                    added_ = NULL;
+                }
+                bool isYielded = false;
+                Coroutine** link = &coroutines_;
+                while(*link != NULL)
+                {
+                    Coroutine* const coroutine = *link;
+                    switch( coroutine->resume() )
+                    {
+                        case Coroutine::YIELDED:
+                            isYielded = true;
+                            link = &coroutine->next_;
+                            break;
+                        case Coroutine::WAITING:
+                            // The sleeping coroutine is woken up by the carrier
+                            if(coroutine->wake_ > time && (wake == 0 || coroutine->wake_ < wake))
+                            {
+                                wake = coroutine->wake_;
+                            }
+                            link = &coroutine->next_;
+                            break;
+                        default:
+                            *link = coroutine->next_;
+                            coroutine->next_ = NULL;
+                            coroutine->scheduler_ = NULL;
+                            coroutine->isDone_ = true;
+                            break;
+                    }
+                }
+                mutex_.unlock();
+                // Sleep if no coroutine is able to run, until an event or the nearest wake-up
+                if(isYielded) continue;
+                if(wake == 0)
+                {
+                    idle(events, 0);
+                    continue;
+                }
+                int64 const rest = wake - Clock::getTime();
+                if(rest > 0)
+                {
+                    idle(events, (rest + 999999) / 1000000);
+                }
+            }
+            return 0;
+        }
+        
+        /**
+         * Returns size of stack.
+         *
+         * @return stack size in bytes.
+         */
+        int32 CoroutineScheduler::getStackSize() const
+        {
+            return STACK_SIZE;
+        }
+        
+        /**
+         * Adds a coroutine for resuming.
+         *
+         * @param coroutine a coroutine which has not been added to any scheduler.
+         * @return true if the coroutine has been added successfully.
+         */
+        bool CoroutineScheduler::add(Coroutine& coroutine)
+        {
+            if( not Self::isConstructed() ) return false;
+            if( not coroutine.isConstructed() ) return false;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("CoroutineScheduler::add");
+                CriticalSection const cs(site, CriticalSection::THREADS);
+                if(coroutine.scheduler_ != NULL) return false;
+                coroutine.scheduler_ = this;
+                coroutine.line_ = 0;
+                coroutine.isDone_ = false;
+                coroutine.next_ = added_;
+                added_ = &coroutine;
+            }
+            notify();
+            return true;
+        }
+        
+        /**
+         * Wakes the carrier thread up if all coroutines are waiting.
+         */
+        void CoroutineScheduler::notify()
+        {
+            if( not Self::isConstructed() ) return;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("CoroutineScheduler::notify");
+            CriticalSection const cs(site);
+            events_++;
+            wake();
+        }
+        
+        /**
+         * Removes a coroutine from the resumption lists.
+         *
+         * @param coroutine a coroutine which has been added to the scheduler.
+         */
+        void CoroutineScheduler::remove(Coroutine& coroutine)
+        {
+            mutex_.lock();
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("CoroutineScheduler::remove");
+                CriticalSection const cs(site, CriticalSection::THREADS);
+                // The coroutine might have completed since its scheduler was read
+                if(coroutine.scheduler_ == this)
+                {
+                    Coroutine** link = &coroutines_;
+                    while(*link != NULL && *link != &coroutine)
+                    {
+                        link = &(*link)->next_;
+                    }
+                    if(*link == NULL)
+                    {
+                        link = &added_;
+                        while(*link != &coroutine)
+                        {
+                            link = &(*link)->next_;
+                        }
+                    }
+                    *link = coroutine.next_;
+                    coroutine.next_ = NULL;
+                    coroutine.scheduler_ = NULL;
+                }
+            }
+            mutex_.unlock();
+        }
+        
+        /**
+         * Detaches the coroutines of a list from the scheduler.
+         *
+         * @param coroutines the first coroutine of the list.
+         */
+        void CoroutineScheduler::detach(Coroutine*& coroutines)
+        {
+            while(coroutines != NULL)
+            {
+                Coroutine* const coroutine = coroutines;
+                coroutines = coroutine->next_;
+                coroutine->next_ = NULL;
+                coroutine->scheduler_ = NULL;
+                if(coroutine->waiting_ != NULL)
+                {
+                    Coroutine::count(*coroutine->waiting_, -1);
+                    coroutine->waiting_ = NULL;
+                }
+            }
+        }
+        
+        /**
+         * Suspends the carrier thread until an event or a timeout.
+         *
+         * @param events the number of events before the resumption of the coroutines.
+         * @param millis a timeout in milliseconds, or zero for waiting without a timeout.
+         */
+        void CoroutineScheduler::idle(uint32 const events, int64 const millis)
+        {
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("CoroutineScheduler::idle");
+                CriticalSection const cs(site);
+                if(events != events_) return;
+                isIdle_ = true;
+                nextIdle_ = idle_;
+                idle_ = this;
+            }
+            uint32 const timeout = millis == 0 ? SEM_INFINITY : static_cast<uint32>(millis);
+            sem_lock(res_, timeout);
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("CoroutineScheduler::idle.wake");
+            CriticalSection const cs(site);
+            // The carrier woken up by the timeout is still idle
+            if(isIdle_)
+            {
+                CoroutineScheduler** link = &idle_;
+                while(*link != this)
+                {
+                    link = &(*link)->nextIdle_;
+                }
+                *link = nextIdle_;
+                isIdle_ = false;
+            }
+        }
+        
+        /**
+         * Wakes the carrier thread up if it is idle.
+         */
+        void CoroutineScheduler::wake()
+        {
+            if( not isIdle_ ) return;
+            CoroutineScheduler** link = &idle_;
+            while(*link != this)
+            {
+                link = &(*link)->nextIdle_;
+            }
+            *link = nextIdle_;
+            isIdle_ = false;
+            sem_unlock(res_);
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @param scheduler the scheduler which creates a carrier thread.
+         * @return true if object has been constructed successfully.
+         */
+        bool CoroutineScheduler::construct(api::Scheduler& scheduler)
+        {
+            if( not Self::isConstructed() ) return false;
+            if( not mutex_.isConstructed() ) return false;
+            res_ = sem_alloc(0, NULL);
+            if(res_ == RES_VOID) return false;
+            thread_ = scheduler.createThread(*this);
+            if(thread_ == NULL) return false;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("CoroutineScheduler::construct");
+                CriticalSection const cs(site);
+                schedulers_++;
+            }
+            thread_->execute();
+            return true;
+        }
+        
+        /**
+         * The number of constructed schedulers.
+         */
+        int32 CoroutineScheduler::schedulers_ = 0;
+        
+        /**
+         * The number of events, which is changed by each notification.
+         */
+        volatile uint32 CoroutineScheduler::events_ = 0;
+        
+        /**
+         * The idle schedulers.
+         */
+        CoroutineScheduler* CoroutineScheduler::idle_ = NULL;
+        
+        /** 
+         * Destructor.
+         */
+        Coroutine::~Coroutine()
+        {
+            remove();
+        }
+        
+        /**
+         * Removes the coroutine from its scheduler.
+         */
+        void Coroutine::remove()
+        {
+            CoroutineScheduler* const scheduler = scheduler_;
+            if(scheduler != NULL)
+            {
+                scheduler->remove(*this);
+            }
+            // The coroutine added again begins from the start, and does not wait for a primitive
+            if(waiting_ != NULL)
+            {
+                count(*waiting_, -1);
+                waiting_ = NULL;
+            }
+        }
+        
+        /**
+         * Wakes the idle coroutine schedulers up.
+         */
+        void Coroutine::notifyAll()
+        {
+            // The system semaphores are released without the section if no scheduler has been constructed
+            if(CoroutineScheduler::schedulers_ == 0) return;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Coroutine::notifyAll");
+            CriticalSection const cs(site);
+            CoroutineScheduler::events_++;
+            while(CoroutineScheduler::idle_ != NULL)
+            {
+                CoroutineScheduler::idle_->wake();
+            }
+        }
+        
+        /**
+         * Changes the number of coroutines waiting for a primitive.
+         *
+         * @param coroutines the number of coroutines waiting for a primitive.
+         * @param number     one for a coroutine starting waiting, or minus one for a coroutine ending.
+         */
+        void Coroutine::count(volatile int32& coroutines, int32 const number)
+        {
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Coroutine::count");
+            CriticalSection const cs(site);
+            coroutines += number;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/** 
+ * Critical section guard.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.CriticalSection.hpp"
+
+namespace local
+{ 
+    namespace system
+    {
+        /**
+         * Returns the first site of the sites list.
+         *
+         * @return the site, or NULL if no site has been measured.
+         */
+        const CriticalSection::Site* CriticalSection::getSites()
+        {
+            return sites_;
+        }
+        
+        /**
+         * Resets statistics of all sites.
+         */
+        void CriticalSection::reset()
+        {
+            bool const is = Interrupt::disableAll();
+            for(Site* site = sites_; site != NULL; site = site->next)
+            {
+                site->count = 0;
+                site->max = 0;
+                site->total = 0;
+                site->type = INTERRUPTS;
+            }
+            Interrupt::enableAll(is);
+        }
+        
+        /**
+         * Records a critical section to the site statistics.
+         *
+         * @param site     a call site of the critical section.
+         * @param type     a type of the critical section.
+         * @param duration the critical section duration in nanoseconds.
+         */
+        void CriticalSection::record(Site& site, Type const type, int64 const duration)
+        {
+            // The interrupts are disabled for linking a site of threads type 
+            bool const is = Interrupt::disableAll();
+            if( not site.isLinked )
+            {
+                site.next = sites_;
+                sites_ = &site;
+                site.isLinked = true;
+            }
+            if(duration > site.max)
+            {
+                site.max = duration;
+                site.type = type;
+            }
+            site.count++;
+            site.total += duration;
+            Interrupt::enableAll(is);
+        }
+        
+        /**
+         * The sites list.
+         */
+        CriticalSection::Site* CriticalSection::sites_ = NULL;
+    }
+}
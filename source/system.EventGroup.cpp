@@ -0,0 +1,294 @@
+/** 
+ * Group of event flags.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.EventGroup.hpp"
+#include "system.CriticalSection.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /** 
+         * Constructor.
+         *
+         * @param flags the initial value of the flags.
+         */
+        EventGroup::EventGroup(uint32 const flags) : Parent(),
+            flags_   (flags),
+            waiters_ (NULL),
+            free_    (NULL){
+            bool const isConstructed = construct();
+            setConstructed( isConstructed );
+        }
+        
+        /** 
+         * Destructor.
+         */
+        EventGroup::~EventGroup()
+        {
+            while(free_ != NULL)
+            {
+                Waiter* const waiter = free_;
+                free_ = waiter->next;
+                delete waiter->sem;
+                delete waiter;
+            }
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool EventGroup::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Sets flags, and wakes the waiting threads up.
+         *
+         * @param mask the flags to set.
+         * @return the flags after setting.
+         */
+        uint32 EventGroup::set(uint32 const mask)
+        {
+            if( not Self::isConstructed() ) return 0;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("EventGroup::set");
+            CriticalSection const cs(site);
+            flags_ |= mask;
+            // All the threads the flags satisfy are woken up before the flags are cleared
+            uint32 clear = 0;
+            Waiter** link = &waiters_;
+            while(*link != NULL)
+            {
+                Waiter* const waiter = *link;
+                uint32 const flags = match(flags_, waiter->mask, waiter->isAll);
+                if(flags == 0)
+                {
+                    link = &waiter->next;
+                    continue;
+                }
+                *link = waiter->next;
+                waiter->flags = flags;
+                if(waiter->isClear)
+                {
+                    clear |= waiter->mask;
+                }
+                waiter->sem->release();
+            }
+            flags_ &= ~clear;
+            return flags_;
+        }
+        
+        /**
+         * Clears flags.
+         *
+         * @param mask the flags to clear.
+         * @return the flags before clearing.
+         */
+        uint32 EventGroup::clear(uint32 const mask)
+        {
+            if( not Self::isConstructed() ) return 0;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("EventGroup::clear");
+            CriticalSection const cs(site);
+            uint32 const flags = flags_;
+            flags_ &= ~mask;
+            return flags;
+        }
+        
+        /**
+         * Returns the flags.
+         *
+         * @return the current flags.
+         */
+        uint32 EventGroup::get() const
+        {
+            return flags_;
+        }
+        
+        /**
+         * Waits for flags.
+         *
+         * @param mask    the flags to wait for.
+         * @param isAll   true for waiting for all the flags, or false for any of them.
+         * @param isClear true for clearing the flags of the mask on successful waiting.
+         * @return the flags of the mask, which have been set, or zero if an error has been occurred.
+         */
+        uint32 EventGroup::wait(uint32 const mask, bool const isAll, bool const isClear)
+        {
+            return waitFlags(mask, isAll, isClear, -1);
+        }
+        
+        /**
+         * Waits for flags during a timeout.
+         *
+         * @param mask    the flags to wait for.
+         * @param isAll   true for waiting for all the flags, or false for any of them.
+         * @param isClear true for clearing the flags of the mask on successful waiting.
+         * @param millis  a timeout in milliseconds, or zero for a try without waiting.
+         * @return the flags of the mask, which have been set, or zero if the timeout has expired.
+         */
+        uint32 EventGroup::wait(uint32 const mask, bool const isAll, bool const isClear, int64 const millis)
+        {
+            if(millis < 0) return 0;
+            return waitFlags(mask, isAll, isClear, millis);
+        }
+        
+        /**
+         * Tests if flags satisfy a waiting.
+         *
+         * @param flags   the flags.
+         * @param mask    the flags to wait for.
+         * @param isAll   true for waiting for all the flags, or false for any of them.
+         * @return the flags of the mask, which satisfy the waiting, or zero.
+         */
+        uint32 EventGroup::match(uint32 const flags, uint32 const mask, bool const isAll)
+        {
+            uint32 const res = flags & mask;
+            if(isAll && res != mask) return 0;
+            return res;
+        }
+        
+        /**
+         * Waits for flags during a timeout.
+         *
+         * @param mask    the flags to wait for.
+         * @param isAll   true for waiting for all the flags, or false for any of them.
+         * @param isClear true for clearing the flags of the mask on successful waiting.
+         * @param millis  a timeout in milliseconds, or a negative value for infinite waiting.
+         * @return the flags of the mask, which have been set, or zero if the timeout has expired.
+         */
+        uint32 EventGroup::waitFlags(uint32 const mask, bool const isAll, bool const isClear, int64 const millis)
+        {
+            if( not Self::isConstructed() ) return 0;
+            if(mask == 0) return 0;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("EventGroup::wait");
+            {
+                CriticalSection const cs(site);
+                uint32 const flags = match(flags_, mask, isAll);
+                if(flags != 0 || millis == 0)
+                {
+                    if(isClear)
+                    {
+                        flags_ &= ~flags;
+                    }
+                    return flags;
+                }
+            }
+            // The thread waits on the semaphore of its waiter, so it is woken up only if its flags are set
+            Waiter* const waiter = takeWaiter();
+            if(waiter == NULL) return 0;
+            waiter->mask = mask;
+            waiter->isAll = isAll;
+            waiter->isClear = isClear;
+            waiter->flags = 0;
+            waiter->next = NULL;
+            {
+                CriticalSection const cs(site);
+                uint32 const flags = match(flags_, mask, isAll);
+                if(flags != 0)
+                {
+                    if(isClear)
+                    {
+                        flags_ &= ~flags;
+                    }
+                    putWaiter(waiter);
+                    return flags;
+                }
+                Waiter** link = &waiters_;
+                while(*link != NULL)
+                {
+                    link = &(*link)->next;
+                }
+                *link = waiter;
+            }
+            // The timeout the OS semaphores cannot count is waited infinitely instead of being truncated
+            bool const isWoken = millis < 0 || millis >= SEM_INFINITY ? waiter->sem->acquire() : waiter->sem->tryAcquire(millis);
+            bool isReleased = false;
+            if( not isWoken )
+            {
+                CriticalSection const cs(site);
+                // The flags might have been set after the timeout expiration
+                if(waiter->flags == 0)
+                {
+                    Waiter** link = &waiters_;
+                    while(*link != waiter)
+                    {
+                        link = &(*link)->next;
+                    }
+                    *link = waiter->next;
+                }
+                else
+                {
+                    isReleased = true;
+                }
+            }
+            // The permit released after the timeout expiration is not left for the next waiting
+            if(isReleased)
+            {
+                waiter->sem->acquire();
+            }
+            uint32 const flags = waiter->flags;
+            putWaiter(waiter);
+            return flags;
+        }
+        
+        /**
+         * Takes a free waiter, or creates a new one.
+         *
+         * @return a waiter, or NULL if an error has been occurred.
+         */
+        EventGroup::Waiter* EventGroup::takeWaiter()
+        {
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("EventGroup::takeWaiter");
+                CriticalSection const cs(site);
+                Waiter* const waiter = free_;
+                if(waiter != NULL)
+                {
+                    free_ = waiter->next;
+                    return waiter;
+                }
+            }
+            Waiter* const waiter = new Waiter;
+            if(waiter == NULL) return NULL;
+            waiter->sem = new Semaphore(0);
+            if(waiter->sem == NULL || not waiter->sem->isConstructed())
+            {
+                delete waiter->sem;
+                delete waiter;
+                return NULL;
+            }
+            return waiter;
+        }
+        
+        /**
+         * Puts a waiter, which has no permit of its semaphore, to the free waiters.
+         *
+         * @param waiter a waiter taken by the takeWaiter function.
+         */
+        void EventGroup::putWaiter(Waiter* const waiter)
+        {
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("EventGroup::putWaiter");
+            CriticalSection const cs(site);
+            waiter->next = free_;
+            free_ = waiter;
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool EventGroup::construct()
+        {
+            if( not Self::isConstructed() ) return false;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,276 @@
+/** 
+ * Result of a task executed asynchronously.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Future.hpp"
+#include "system.CriticalSection.hpp"
+#include "api.Thread.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /** 
+         * Constructor.
+         *
+         * @param scheduler the scheduler which creates a thread of the task.
+         * @param task      a user task.
+         */
+        Future::Future(api::Scheduler& scheduler, api::Task& task) : Parent(),
+            scheduler_     (scheduler),
+            task_          (task),
+            result_        (-1),
+            ready_         (1),
+            thread_        (NULL),
+            antecedent_    (NULL),
+            continuations_ (NULL),
+            next_          (NULL){
+            bool const isConstructed = construct(NULL);
+            setConstructed( isConstructed );
+        }
+        
+        /** 
+         * Constructor of a continuation.
+         *
+         * @param scheduler  the scheduler which creates a thread of the task.
+         * @param task       a user task.
+         * @param antecedent the future after which the task is started.
+         */
+        Future::Future(api::Scheduler& scheduler, api::Task& task, Future& antecedent) : Parent(),
+            scheduler_     (scheduler),
+            task_          (task),
+            result_        (-1),
+            ready_         (1),
+            thread_        (NULL),
+            antecedent_    (NULL),
+            continuations_ (NULL),
+            next_          (NULL){
+            bool const isConstructed = construct(&antecedent);
+            setConstructed( isConstructed );
+        }
+        
+        /** 
+         * Destructor.
+         */
+        Future::~Future()
+        {
+            // A future which has failed to be constructed has never been started
+            bool isStarted = Self::isConstructed();
+            bool isCancelled = false;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Future::~Future");
+                CriticalSection const cs(site, CriticalSection::THREADS);
+                if(antecedent_ != NULL)
+                {
+                    Future** link = &antecedent_->continuations_;
+                    while(*link != this)
+                    {
+                        link = &(*link)->next_;
+                    }
+                    *link = next_;
+                    antecedent_ = NULL;
+                    isStarted = false;
+                    isCancelled = true;
+                }
+            }
+            if(isStarted)
+            {
+                ready_.await();
+            }
+            if(isCancelled)
+            {
+                complete(-1, false);
+            }
+            if(thread_ != NULL)
+            {
+                thread_->join();
+                delete thread_;
+            }
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool Future::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Executes the user task, and starts its continuations.
+         *
+         * @return the user task result.
+         */        
+        int32 Future::start()
+        {
+            int32 const result = task_.start();
+            complete(result, true);
+            return result;
+        }
+        
+        /**
+         * Returns size of stack.
+         *
+         * @return the user task stack size in bytes.
+         */
+        int32 Future::getStackSize() const
+        {
+            return task_.getStackSize();
+        }
+        
+        /**
+         * Tests if the task has completed.
+         *
+         * @return true if the result is ready.
+         */
+        bool Future::isReady() const
+        {
+            return ready_.isOpen();
+        }
+        
+        /**
+         * Waits for the completion of the task.
+         *
+         * @return true if the result is ready.
+         */
+        bool Future::wait()
+        {
+            if( not Self::isConstructed() ) return false;
+            return ready_.await();
+        }
+        
+        /**
+         * Waits for the completion of the task during a timeout.
+         *
+         * @param millis a timeout in milliseconds, or zero for a test without waiting.
+         * @return true if the result is ready.
+         */
+        bool Future::wait(int64 const millis)
+        {
+            if( not Self::isConstructed() ) return false;
+            return ready_.await(millis);
+        }
+        
+        /**
+         * Waits for the completion of the task, and returns its result.
+         *
+         * @return the value returned by the task start function, or -1 if the task has not been executed.
+         */
+        int32 Future::get()
+        {
+            if( not wait() ) return -1;
+            return result_;
+        }
+        
+        /**
+         * Creates a continuation of the task.
+         *
+         * @param task a user task.
+         * @return a new future of the continuation task, or NULL if an error has been occurred.
+         */
+        Future* Future::then(api::Task& task)
+        {
+            if( not Self::isConstructed() ) return NULL;
+            Future* const future = new Future(scheduler_, task, *this);
+            if(future == NULL) return NULL;
+            if(future->isConstructed()) return future;
+            delete future;
+            return NULL;
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @param antecedent the future after which the task is started, or NULL to start it at once.
+         * @return true if object has been constructed successfully.
+         */
+        bool Future::construct(Future* const antecedent)
+        {
+            if( not Self::isConstructed() ) return false;
+            if( not task_.isConstructed() ) return false;
+            if( not ready_.isConstructed() ) return false;
+            if(antecedent != NULL)
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Future::construct");
+                CriticalSection const cs(site, CriticalSection::THREADS);
+                // The continuation waits if the antecedent has not completed yet
+                if( not antecedent->isReady() )
+                {
+                    antecedent_ = antecedent;
+                    next_ = antecedent->continuations_;
+                    antecedent->continuations_ = this;
+                    return true;
+                }
+            }
+            execute();
+            return true;
+        }
+        
+        /**
+         * Starts the task in a new thread.
+         */
+        void Future::execute()
+        {
+            api::Thread* const thread = scheduler_.createThread(*this);
+            bool isExecuted = false;
+            if(thread != NULL)
+            {
+                // The task completes the future in a section of the same type, 
+                // so the future and its thread are not deleted while the thread is tested
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Future::execute");
+                CriticalSection const cs(site, CriticalSection::THREADS);
+                thread_ = thread;
+                thread->execute();
+                // The thread is dead without an identifier if its OS process has not been created
+                isExecuted = thread->getStatus() != api::Thread::DEAD || thread->getId() >= 0;
+            }
+            if( not isExecuted )
+            {
+                complete(-1, true);
+            }
+        }
+        
+        /**
+         * Completes the future with a result, and starts or cancels the continuations.
+         *
+         * @param result      the task result.
+         * @param isContinued true for starting the continuations, or false for cancelling them.
+         */
+        void Future::complete(int32 const result, bool const isContinued)
+        {
+            Future* continuation;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Future::complete");
+                CriticalSection const cs(site, CriticalSection::THREADS);
+                result_ = result;
+                // The latch is opened in the section for the continuations being constructed
+                ready_.countDown();
+                continuation = continuations_;
+                continuations_ = NULL;
+                for(Future* future = continuation; future != NULL; future = future->next_)
+                {
+                    future->antecedent_ = NULL;
+                }
+            }
+            while(continuation != NULL)
+            {
+                Future* const next = continuation->next_;
+                continuation->next_ = NULL;
+                if(isContinued)
+                {
+                    continuation->execute();
+                }
+                else
+                {
+                    continuation->complete(-1, false);
+                }
+                continuation = next;
+            }
+        }
+    }
+}
@@ -7,6 +7,7 @@
  */
 #include "system.Heap.hpp"
 #include "system.Allocator.hpp"
+#include "system.BootTrace.hpp"
 #include "os.h"
 
 namespace local
@@ -18,6 +19,7 @@ namespace local
          */     
         Heap::Heap() : Parent()
         {
+            BootTrace::mark("Heap");
         }
     
         /** 
@@ -69,5 +71,27 @@ namespace local
         {
             Allocator::free(ptr);
         }
+        
+        /**
+         * Changes the size of an allocated memory.
+         *
+         * @param ptr  - pointer to allocated memory, or NULL for allocating.
+         * @param size - required memory size in byte.
+         * @return pointer to resized memory, or NULL if the memory is not resized.
+         */
+        void* Heap::reallocate(void* const ptr, size_t const size)
+        {
+            return Allocator::reallocate(ptr, size);
+        }
+        
+        /**
+         * Reports the free space and the fragmentation of the heap.
+         *
+         * @param space the free space.
+         */
+        void Heap::getFreeSpace(Allocator::FreeSpace& space) const
+        {
+            Allocator::getFreeSpace(space);
+        }
     }
 }
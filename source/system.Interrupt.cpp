@@ -6,6 +6,10 @@
  * @license   http://embedded.team/license/
  */
 #include "system.Interrupt.hpp"
+#include "system.InterruptService.hpp"
+#include "system.CriticalSection.hpp"
+#include "system.Trace.hpp"
+#include "system.Clock.hpp"
 #include "os.h" 
 
 namespace local
@@ -20,8 +24,24 @@ namespace local
          */
         Interrupt::Interrupt(api::Task& handler, int32 source) : Parent(),
             res_   (RES_VOID),
+            sem_   (RES_VOID),
             index_ (-1){
-            bool const isConstructed = construct(&handler, source);
+            bool const isConstructed = construct(&handler, source, NULL);
+            setConstructed( isConstructed );
+        }
+        
+        /**
+         * Constructor of a deferred interrupt.
+         *
+         * @param handler pointer to user class which implements an interrupt handler interface.   
+         * @param source  available interrupt source.
+         * @param service deferred interrupt processing service.
+         */
+        Interrupt::Interrupt(api::Task& handler, int32 source, InterruptService& service) : Parent(),
+            res_   (RES_VOID),
+            sem_   (RES_VOID),
+            index_ (-1){
+            bool const isConstructed = construct(&handler, source, &service);
             setConstructed( isConstructed );
         }
         
@@ -30,12 +50,37 @@ namespace local
          */
         Interrupt::~Interrupt()
         {
-            bool const is = disableAll();
-            int_free(res_);
-            res_ = RES_VOID;
-            handler_[index_] = NULL;
-            index_ = NULL;
-            enableAll(is);    
+            // The source is freed first, so the vector cannot post the handler being detached again
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Interrupt::~Interrupt.free");
+                CriticalSection const cs(site);
+                if(res_ != RES_VOID)
+                {
+                    int_free(res_);
+                    res_ = RES_VOID;
+                }
+            }
+            if(index_ >= 0 && service_[index_] != NULL)
+            {
+                service_[index_]->detach(index_);
+            }
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Interrupt::~Interrupt");
+            CriticalSection const cs(site);
+            if(index_ >= 0)
+            {
+                handler_[index_] = NULL;
+                service_[index_] = NULL;
+                semaphore_[index_] = RES_VOID;
+                isJumping_[index_] = false;
+                waiters_[index_] = 0;
+                freeIndex(index_);
+                index_ = -1;
+            }
+            if(sem_ != RES_VOID)
+            {
+                sem_free(sem_);
+                sem_ = RES_VOID;
+            }
         }
         
         /**
@@ -43,48 +88,36 @@ namespace local
          *
          * @param handler pointer to user class which implements an interrupt handler interface.   
          * @param source  available interrupt source.
+         * @param service deferred interrupt processing service, or NULL.
          * @return true if object has been constructed successfully.
          */
-        bool Interrupt::construct(api::Task* handler, int32 source)
+        bool Interrupt::construct(api::Task* handler, int32 source, InterruptService* service)
         {
             if( not Self::isConstructed() ) return false;
             bool ret = false;        
-            bool const is = disableAll();
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Interrupt::construct");
+            CriticalSection const cs(site);
             do
             {      
-                void (*func)() = NULL;        
-                for(int32 i=0; i<HANDLERS_NUMBER; i++)
-                {
-                    if(handler_[i] != NULL) continue;
-                    switch(i)
-                    {
-                        case  0: func = handler00; break;
-                        case  1: func = handler01; break;
-                        case  2: func = handler02; break;
-                        case  3: func = handler03; break;                              
-                        case  4: func = handler04; break;
-                        case  5: func = handler05; break;
-                        case  6: func = handler06; break;
-                        case  7: func = handler07; break;
-                        case  8: func = handler08; break;
-                        case  9: func = handler09; break;
-                        case 10: func = handler10; break;
-                        case 11: func = handler11; break;
-                        default: continue;
-                    }
-                    index_ = i;
-                    break;
-                }
-                if(func == NULL) break;
-                res_ = int_alloc(source, func);
+                sem_ = sem_alloc(0, NULL);
+                if(sem_ == RES_VOID) break;
+                index_ = allocateIndex();
+                if(index_ < 0) break;
+                resetStatistics(index_);
+                res_ = int_alloc(source, Vectors<0, HANDLERS_NUMBER>::get(index_));
                 if(res_ == RES_VOID) break;
                 // Do this for being sure that int_alloc has not unlock alloced vector
                 if(int_lock(res_) != OSE_OK) break;  
+                if(service != NULL)
+                {
+                    if( not service->attach(index_, *handler) ) break;
+                    service_[index_] = service;
+                }
+                semaphore_[index_] = sem_;
                 handler_[index_] = handler;
                 ret = true;
             }
             while(false);
-            enableAll(is);       
             return ret;
         }
       
@@ -103,12 +136,41 @@ namespace local
          */  
         void Interrupt::jump()
         {
-            if( not Self::isConstructed() ) return;
-            bool is = disableAll();
-            isJumping_[index_] = true;
-            set();
-            enableAll(is);
-            while( not isJumping_ );
+            jump(true);
+        }
+        
+        /**
+         * Jumps to interrupt HW vector.
+         *
+         * @param isWait true if the method waits for the interrupt handler completion.
+         * @return true if the interrupt has been raised, and has been handled if it is waited.
+         */  
+        bool Interrupt::jump(bool const isWait)
+        {
+            if( not Self::isConstructed() ) return false;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Interrupt::jump");
+                CriticalSection const cs(site);
+                isJumping_[index_] = true;
+                if(isWait)
+                {
+                    waiters_[index_]++;
+                }
+                set();
+            }
+            if( not isWait ) return true;
+            return sem_lock(sem_, SEM_INFINITY) == SEM_OK ? true : false;
+        }
+        
+        /**
+         * Tests if a jump to interrupt hardware vector has not been handled yet.
+         *
+         * @return true if the interrupt handler has not completed after the last jump.
+         */      
+        bool Interrupt::isJumping() const
+        {
+            if( not Self::isConstructed() ) return false;
+            return isJumping_[index_];
         }
         
         /**
@@ -176,144 +238,216 @@ namespace local
             int_enable(status == true ? 1 : 0);
         }    
         
-        /** 
-         * Interrupt hanlder vector number 0.
+        /**
+         * Allocates a free index in the interrupt handlers table.
+         *
+         * @return the index, or -1 if all indexes are allocated.
          */
-        void Interrupt::handler00()
+        int32 Interrupt::allocateIndex()
         {
-            int32 const vector = 0;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }    
+            uint32 const words = ~words_ & getMask(WORDS_NUMBER);
+            if(words == 0u) return -1;
+            int32 const word = getLowestBit(words);
+            uint32 const mask = getMask(HANDLERS_NUMBER - word * WORD_BITS);
+            int32 const bit = getLowestBit(~indexes_[word] & mask);
+            indexes_[word] |= 1u << bit;
+            if( (indexes_[word] & mask) == mask )
+            {
+                words_ |= 1u << word;
+            }
+            return word * WORD_BITS + bit;
+        }
         
-        /** 
-         * Interrupt hanlder vector number 1.
+        /**
+         * Frees an index in the interrupt handlers table.
+         *
+         * @param index an allocated index.
          */
-        void Interrupt::handler01()
+        void Interrupt::freeIndex(int32 const index)
         {
-            int32 const vector = 1;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }    
+            int32 const word = index / WORD_BITS;
+            int32 const bit = index % WORD_BITS;
+            indexes_[word] &= ~(1u << bit);
+            words_ &= ~(1u << word);
+        }
         
-        /** 
-         * Interrupt hanlder vector number 2.
+        /**
+         * Returns a mask of the lowest bits of a word.
+         *
+         * @param count the number of the lowest bits to be set.
+         * @return the mask.
          */
-        void Interrupt::handler02()
+        uint32 Interrupt::getMask(int32 const count)
         {
-            int32 const vector = 2;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }    
+            return count < WORD_BITS ? (1u << count) - 1u : 0xFFFFFFFFu;
+        }
         
-        /** 
-         * Interrupt hanlder vector number 3.
-         */        
-        void Interrupt::handler03()
-        {
-            int32 const vector = 3;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }                   
-        
-        /** 
-         * Interrupt hanlder vector number 4.
-         */        
-        void Interrupt::handler04()
-        {
-            int32 const vector = 4;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }        
-        
-        /** 
-         * Interrupt hanlder vector number 5.
-         */       
-        void Interrupt::handler05()
+        /**
+         * Returns a number of the lowest set bit of a word.
+         *
+         * @param word a non-zero word.
+         * @return the bit number.
+         */
+        int32 Interrupt::getLowestBit(uint32 const word)
         {
-            int32 const vector = 5;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }        
-        
-        /** 
-         * Interrupt hanlder vector number 6.
+            // The multiplication by a de Bruijn sequence of the isolated bit
+            static const int32 bits[WORD_BITS] = {
+                 0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8, 
+                31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+            };
+            uint32 const lowest = word & (~word + 1u);
+            return bits[(lowest * 0x077CB531u) >> 27];
+        }
+
+        /**
+         * Interrupt handler.
          */
-        void Interrupt::handler06()
+        void Interrupt::handler(int32 const vector)
         {
-            int32 const vector = 6;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }        
-        
-        /** 
-         * Interrupt hanlder vector number 7.
-         */        
-        void Interrupt::handler07()
+            #ifdef SYSTEM_INTERRUPT_STATISTICS
+            int64 const time = Clock::getTime();
+            int32 const nesting = ++nesting_;
+            #endif
+            Trace::record(Trace::INTERRUPT_ENTER, static_cast<uint32>(vector));
+            if( handler_[vector] != NULL )
+            {
+                if( service_[vector] != NULL )
+                {
+                    service_[vector]->post(vector);
+                }
+                else
+                {
+                    handler_[vector]->start();
+                    complete(vector);
+                }
+            }
+            Trace::record(Trace::INTERRUPT_EXIT, static_cast<uint32>(vector));
+            #ifdef SYSTEM_INTERRUPT_STATISTICS
+            nesting_--;
+            record(vector, Clock::getTime() - time, nesting);
+            #endif
+        }
+        
+        #ifdef SYSTEM_INTERRUPT_STATISTICS
+        /**
+         * Records an interrupt handler execution to the vector statistics.
+         *
+         * @param vector   an index of the interrupt handlers table.
+         * @param duration the handler duration in nanoseconds.
+         * @param nesting  the interrupts nesting level of the handler.
+         */
+        void Interrupt::record(int32 const vector, int64 const duration, int32 const nesting)
         {
-            int32 const vector = 7;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }        
-        
-        /** 
-         * Interrupt hanlder vector number 8.
-         */        
-        void Interrupt::handler08()
+            Statistics& stats = statistics_[vector];
+            if(stats.count == 0 || duration < stats.min)
+            {
+                stats.min = duration;
+            }
+            if(duration > stats.max)
+            {
+                stats.max = duration;
+            }
+            if(nesting > stats.nesting)
+            {
+                stats.nesting = nesting;
+            }
+            stats.count++;
+            stats.total += duration;
+            int32 bin = 0;
+            for(int64 micros = duration / 1000; micros != 0; micros >>= 1)
+            {
+                if(bin == HISTOGRAM_SIZE - 1) break;
+                bin++;
+            }
+            stats.histogram[bin]++;
+        }
+        #endif // SYSTEM_INTERRUPT_STATISTICS
+        
+        /**
+         * Returns statistics of an interrupt vector.
+         *
+         * @param vector an index of the interrupt handlers table.
+         * @param stats  the statistics to be filled.
+         * @return true if the statistics have been returned.
+         */
+        bool Interrupt::getStatistics(int32 const vector, Statistics& stats)
         {
-            int32 const vector = 8;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }        
-        
-        /** 
-         * Interrupt hanlder vector number 9.
-         */        
-        void Interrupt::handler09()
+            #ifdef SYSTEM_INTERRUPT_STATISTICS
+            if(vector < 0 || vector >= HANDLERS_NUMBER) return false;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Interrupt::getStatistics");
+            CriticalSection const cs(site);
+            stats = statistics_[vector];
+            return true;
+            #else
+            return false;
+            #endif
+        }
+        
+        /**
+         * Resets statistics of an interrupt vector.
+         *
+         * @param vector an index of the interrupt handlers table.
+         */
+        void Interrupt::resetStatistics(int32 const vector)
         {
-            int32 const vector = 9;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }        
-        
-        /** 
-         * Interrupt hanlder vector number 10.
-         */        
-        void Interrupt::handler10()
+            #ifdef SYSTEM_INTERRUPT_STATISTICS
+            if(vector < 0 || vector >= HANDLERS_NUMBER) return;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Interrupt::resetStatistics");
+            CriticalSection const cs(site);
+            Statistics& stats = statistics_[vector];
+            stats.count = 0;
+            stats.min = 0;
+            stats.max = 0;
+            stats.total = 0;
+            stats.nesting = 0;
+            for(int32 i=0; i<HISTOGRAM_SIZE; i++)
+            {
+                stats.histogram[i] = 0;
+            }
+            #endif
+        }
+        
+        /**
+         * Returns statistics of this interrupt.
+         *
+         * @param stats the statistics to be filled.
+         * @return true if the statistics have been returned.
+         */
+        bool Interrupt::getStatistics(Statistics& stats) const
         {
-            int32 const vector = 10;
-            if( handler_[vector] == NULL ) return;
-            isJumping_[vector] = false;
-            handler_[vector]->start();
-        }        
-        
-        /** 
-         * Interrupt hanlder vector number 11.
-         */        
-        void Interrupt::handler11()
+            if( not Self::isConstructed() ) return false;
+            return getStatistics(index_, stats);
+        }
+        
+        /**
+         * Resets statistics of this interrupt.
+         */
+        void Interrupt::resetStatistics()
         {
-            handler(11);
+            if( not Self::isConstructed() ) return;
+            resetStatistics(index_);
         }
-
+        
         /**
-         * Interrupt handler.
+         * Completes an interrupt handler execution.
+         *
+         * @param vector an index of the interrupt handlers table.
          */
-        void Interrupt::handler(int32 const vector)
+        void Interrupt::complete(int32 const vector)
         {
-            if( handler_[vector] != NULL )
+            int32 waiters;
+            uint32 sem;
             {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Interrupt::complete");
+                CriticalSection const cs(site);
+                waiters = waiters_[vector];
+                sem = semaphore_[vector];
                 isJumping_[vector] = false;
-                handler_[vector]->start();
+                waiters_[vector] = 0;
+            }
+            for(int32 i=0; i<waiters; i++)
+            {
+                sem_unlock(sem);
             }
         }
         
@@ -322,9 +456,48 @@ namespace local
          */        
         api::Task* Interrupt::handler_[Interrupt::HANDLERS_NUMBER] = { NULL };
         
+        /**
+         * Deferred interrupt processing services of handlers.
+         */        
+        InterruptService* Interrupt::service_[Interrupt::HANDLERS_NUMBER] = { NULL };
+        
+        /**
+         * Allocated indexes bitmap of interrupt handlers table.
+         */
+        uint32 Interrupt::indexes_[Interrupt::WORDS_NUMBER] = { 0 };
+        
+        /**
+         * Bitmap of completely allocated words of the indexes bitmap.
+         */
+        uint32 Interrupt::words_ = 0;
+        
         /**
          * An interrupt resource is called jump method.
          */            
-        bool Interrupt::isJumping_[HANDLERS_NUMBER] = { false };
+        bool Interrupt::isJumping_[Interrupt::HANDLERS_NUMBER] = { false };
+        
+        /**
+         * The number of threads waiting for the handler completion.
+         */        
+        int32 Interrupt::waiters_[Interrupt::HANDLERS_NUMBER] = { 0 };
+        
+        /**
+         * The OS semaphore resources of waiting for the handler completion.
+         */        
+        uint32 Interrupt::semaphore_[Interrupt::HANDLERS_NUMBER] = { 0 };
+        
+        #ifdef SYSTEM_INTERRUPT_STATISTICS
+        
+        /**
+         * Statistics of interrupt vectors.
+         */        
+        Interrupt::Statistics Interrupt::statistics_[Interrupt::HANDLERS_NUMBER];
+        
+        /**
+         * The current interrupts nesting level.
+         */        
+        int32 Interrupt::nesting_ = 0;
+        
+        #endif // SYSTEM_INTERRUPT_STATISTICS
     }
 }
@@ -0,0 +1,225 @@
+/** 
+ * Deferred interrupt processing service.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.InterruptService.hpp"
+#include "system.CriticalSection.hpp"
+
+namespace local
+{ 
+    namespace system
+    {
+        /**
+         * Constructor.
+         *
+         * @param scheduler the scheduler which creates a service thread.
+         */
+        InterruptService::InterruptService(api::Scheduler& scheduler) : Parent(),
+            isPending_  (false),
+            isStopping_ (false),
+            sem_        (0),
+            mutex_      (),
+            scheduler_  (scheduler),
+            thread_     (NULL){
+            bool const isConstructed = construct();
+            setConstructed( isConstructed );
+        }
+        
+        /**
+         * Destructor.
+         */
+        InterruptService::~InterruptService()
+        {
+            if(thread_ != NULL)
+            {
+                isStopping_ = true;
+                sem_.release();
+                thread_->join();
+                delete thread_;
+            }
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool InterruptService::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Executes deferred interrupt handlers.
+         *
+         * @return zero, or error code if an error has been occurred.
+         */        
+        int32 InterruptService::start()
+        {
+            uint32 pending[WORDS_NUMBER];
+            while(true)
+            {
+                if( not sem_.acquire() ) return -1;
+                if(isStopping_) break;
+                // Take all pending handlers at once for being posted again by interrupts
+                {
+                    static CriticalSection::Site site = CRITICAL_SECTION_SITE("InterruptService::start");
+                    CriticalSection const cs(site);
+                    for(int32 i=0; i<WORDS_NUMBER; i++)
+                    {
+                        pending[i] = pending_[i];
+                        pending_[i] = 0;
+                    }
+                    isPending_ = false;
+                }
+                for(int32 i=0; i<WORDS_NUMBER; i++)
+                {
+                    for(int32 j=0; pending[i] != 0; j++)
+                    {
+                        uint32 const bit = 1u << j;
+                        if( (pending[i] & bit) == 0 ) continue;
+                        pending[i] &= ~bit;
+                        mutex_.lock();
+                        int32 const vector = i * WORD_BITS + j;
+                        api::Task* const handler = handler_[vector];
+                        if(handler != NULL)
+                        {
+                            handler->start();
+                            Interrupt::complete(vector);
+                        }
+                        mutex_.unlock();
+                    }
+                }
+            }
+            return 0;
+        }
+        
+        /**
+         * Returns size of stack.
+         *
+         * @return stack size in bytes.
+         */
+        int32 InterruptService::getStackSize() const
+        {
+            return STACK_SIZE;
+        }
+        
+        /**
+         * Attaches a deferred handler of an interrupt vector.
+         *
+         * @param vector  an index of the interrupt handlers table.
+         * @param handler a user interrupt handler.
+         * @return true if the handler has been attached successfully.
+         */
+        bool InterruptService::attach(int32 const vector, api::Task& handler)
+        {
+            if( not Self::isConstructed() ) return false;
+            if(vector < 0 || vector >= Interrupt::HANDLERS_NUMBER) return false;
+            if( not createThread() ) return false;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("InterruptService::attach");
+            CriticalSection const cs(site);
+            if(handler_[vector] != NULL) return false;
+            handler_[vector] = &handler;
+            return true;
+        }
+        
+        /**
+         * Detaches a deferred handler of an interrupt vector.
+         *
+         * @param vector an index of the interrupt handlers table.
+         */
+        void InterruptService::detach(int32 const vector)
+        {
+            if( not Self::isConstructed() ) return;
+            if(vector < 0 || vector >= Interrupt::HANDLERS_NUMBER) return;
+            // Wait for the handler if it is being executed now
+            mutex_.lock();
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("InterruptService::detach");
+                CriticalSection const cs(site);
+                pending_[vector / WORD_BITS] &= ~(1u << vector % WORD_BITS);
+                handler_[vector] = NULL;
+            }
+            mutex_.unlock();
+        }
+        
+        /**
+         * Posts a deferred handler of an interrupt vector for executing.
+         *
+         * @param vector an index of the interrupt handlers table.
+         */
+        void InterruptService::post(int32 const vector)
+        {
+            if( not Self::isConstructed() ) return;
+            bool isRelease;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("InterruptService::post");
+                CriticalSection const cs(site);
+                pending_[vector / WORD_BITS] |= 1u << vector % WORD_BITS;
+                isRelease = isPending_ ? false : true;
+                isPending_ = true;
+            }
+            if(isRelease)
+            {
+                sem_.release();
+            }
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool InterruptService::construct()
+        {
+            if( not Self::isConstructed() ) return false;
+            if( not sem_.isConstructed() ) return false;
+            if( not mutex_.isConstructed() ) return false;
+            for(int32 i=0; i<Interrupt::HANDLERS_NUMBER; i++)
+            {
+                handler_[i] = NULL;
+            }
+            for(int32 i=0; i<WORDS_NUMBER; i++)
+            {
+                pending_[i] = 0;
+            }
+            return true;
+        }
+        
+        /**
+         * Creates the service thread if it has not been created.
+         *
+         * @return true if the service thread has been created.
+         */
+        bool InterruptService::createThread()
+        {
+            // The creation is serialized by the mutex, which is held by the service thread for one handler at most
+            if( not mutex_.lock() ) return false;
+            if(thread_ == NULL)
+            {
+                api::Thread* const thread = scheduler_.createThread(*this);
+                if(thread != NULL)
+                {
+                    // Deferred handlers must preempt the threads they are deferred from
+                    thread->setPriority(api::Thread::MAX_PRIORITY);
+                    thread->execute();
+                    // The thread is dead without an identifier if its OS process has not been created
+                    if(thread->getStatus() == api::Thread::DEAD && thread->getId() < 0)
+                    {
+                        delete thread;
+                    }
+                    else
+                    {
+                        thread_ = thread;
+                    }
+                }
+            }
+            bool const isCreated = thread_ != NULL;
+            mutex_.unlock();
+            return isCreated;
+        }
+    }
+}
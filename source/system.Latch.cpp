@@ -0,0 +1,142 @@
+/** 
+ * One-shot countdown latch.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Latch.hpp"
+#include "system.CriticalSection.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /** 
+         * Constructor.
+         *
+         * @param count the number of count downs to open the latch.
+         */
+        Latch::Latch(int32 const count) : Parent(),
+            count_   (count),
+            waiting_ (0),
+            gate_    (0){
+            bool const isConstructed = construct();
+            setConstructed( isConstructed );
+        }
+        
+        /** 
+         * Destructor.
+         */
+        Latch::~Latch()
+        {
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool Latch::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Decrements the count, and opens the latch if the count reaches zero.
+         */
+        void Latch::countDown()
+        {
+            if( not Self::isConstructed() ) return;
+            int32 waiting = 0;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Latch::countDown");
+                CriticalSection const cs(site);
+                if(count_ > 0)
+                {
+                    count_--;
+                    if(count_ == 0)
+                    {
+                        waiting = waiting_;
+                        waiting_ = 0;
+                    }
+                }
+            }
+            // The OS semaphores have no broadcast, so the permits are released one by one with the interrupts enabled
+            for(int32 i=0; i<waiting; i++)
+            {
+                gate_.release();
+            }
+        }
+        
+        /**
+         * Waits until the latch is open.
+         *
+         * @return true if the latch is open.
+         */
+        bool Latch::await()
+        {
+            if( not Self::isConstructed() ) return false;
+            if(count_ == 0) return true;
+            if( not wait() ) return true;
+            return gate_.acquire();
+        }
+        
+        /**
+         * Waits until the latch is open during a timeout.
+         *
+         * @param millis a timeout in milliseconds, or zero for a test without waiting.
+         * @return true if the latch is open.
+         */
+        bool Latch::await(int64 const millis)
+        {
+            if( not Self::isConstructed() ) return false;
+            if(count_ == 0) return true;
+            if( not wait() ) return true;
+            if( gate_.tryAcquire(millis) ) return true;
+            // The thread which has not been woken up is not waiting anymore
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Latch::await.timeout");
+            CriticalSection const cs(site);
+            if(count_ == 0) return true;
+            waiting_--;
+            return false;
+        }
+        
+        /**
+         * Tests if the latch is open.
+         *
+         * @return true if the count has reached zero.
+         */
+        bool Latch::isOpen() const
+        {
+            return count_ == 0 ? true : false;
+        }
+        
+        /**
+         * Counts the calling thread as a waiting one if the latch is not open.
+         *
+         * @return true if the thread has to wait.
+         */
+        bool Latch::wait()
+        {
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Latch::wait");
+            CriticalSection const cs(site);
+            if(count_ == 0) return false;
+            waiting_++;
+            return true;
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool Latch::construct()
+        {
+            if( not Self::isConstructed() ) return false;
+            if(count_ < 0) return false;
+            if( not gate_.isConstructed() ) return false;
+            return true;
+        }
+    }
+}
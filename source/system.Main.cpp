@@ -6,6 +6,7 @@
  * @license   http://embedded.team/license/
  */
 #include "system.System.hpp"
+#include "system.BootTrace.hpp"
 
 /**
  * Executes a user application main process.
@@ -14,6 +15,7 @@
  */
 int os_main(void* const args)
 {
+    ::local::system::BootTrace::mark("os_main");
     ::local::system::System eoos;
     return eoos.execute();
 }
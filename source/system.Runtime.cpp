@@ -0,0 +1,46 @@
+/**
+ * Runtime system execution.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Runtime.hpp"
+#include "system.System.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Loads a program for executing asynchronously.
+         *
+         * @param path a system path to a program.
+         * @return the loading, or NULL if an error has been occurred.
+         */    
+        RuntimeLoading* Runtime::loadAsync(const char* const path)
+        {
+            // The loading copies the path pointer, so the array might be local
+            const char* const paths[] = {path};
+            return loadAsync(paths, 1);
+        }
+        
+        /**
+         * Loads programs for executing asynchronously.
+         *
+         * @param paths  system paths to programs.
+         * @param number the number of the paths.
+         * @return the loading, or NULL if an error has been occurred.
+         */    
+        RuntimeLoading* Runtime::loadAsync(const char* const* const paths, int32 const number)
+        {
+            if( not Self::isConstructed() ) return NULL;
+            api::Scheduler& scheduler = System::call().getScheduler();
+            RuntimeLoading* res = new RuntimeLoading(*this, scheduler, paths, number);
+            if(res == NULL) return NULL;
+            if(res->isConstructed()) return res;
+            delete res;
+            return NULL;
+        }
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * Asynchronous loading of programs.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.RuntimeLoading.hpp"
+#include "system.CriticalSection.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /** 
+         * Constructor.
+         *
+         * @param runtime   the runtime which loads the programs.
+         * @param scheduler the scheduler which creates loading threads.
+         * @param paths     system paths to programs.
+         * @param number    the number of the paths.
+         */     
+        RuntimeLoading::RuntimeLoading(api::Runtime& runtime, api::Scheduler& scheduler, const char* const* paths, int32 number) : Parent(),
+            runtime_ (runtime),
+            number_  (number),
+            next_    (0),
+            done_    (0){
+            setConstructed( construct(scheduler, paths) );
+        }
+      
+        /** 
+         * Destructor.
+         */
+        RuntimeLoading::~RuntimeLoading()
+        {
+            wait();
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool RuntimeLoading::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Loads programs in a loading thread.
+         *
+         * @return zero.
+         */        
+        int32 RuntimeLoading::start()
+        {
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("RuntimeLoading::start");
+            while(true)
+            {
+                int32 index;
+                {
+                    CriticalSection const cs(site);
+                    index = next_ < number_ ? next_++ : -1;
+                }
+                if(index < 0) break;
+                bool const isLoaded = runtime_.load(paths_[index]);
+                {
+                    CriticalSection const cs(site);
+                    isLoaded_[index] = isLoaded;
+                    done_++;
+                }
+            }
+            return 0;
+        }
+        
+        /**
+         * Returns size of stack.
+         *
+         * @return stack size in bytes.
+         */
+        int32 RuntimeLoading::getStackSize() const
+        {
+            return STACK_SIZE;
+        }
+        
+        /**
+         * Tests if all programs have been processed.
+         *
+         * @return true if the loading has been completed.
+         */
+        bool RuntimeLoading::isDone() const
+        {
+            return done_ == number_ ? true : false;
+        }
+        
+        /**
+         * Waits for the loading completion.
+         *
+         * @return true if all programs have been loaded successfully.
+         */
+        bool RuntimeLoading::wait()
+        {
+            for(int32 i=0; i<THREADS_NUMBER; i++)
+            {
+                if(threads_[i] == NULL) continue;
+                threads_[i]->join();
+                delete threads_[i];
+                threads_[i] = NULL;
+            }
+            if( not isDone() ) return false;
+            for(int32 i=0; i<number_; i++)
+            {
+                if( not isLoaded_[i] ) return false;
+            }
+            return true;
+        }
+        
+        /**
+         * Tests if a program has been loaded.
+         *
+         * @param index an index of the program path.
+         * @return true if the program has been loaded successfully.
+         */
+        bool RuntimeLoading::isLoaded(int32 const index) const
+        {
+            if(index < 0 || index >= number_) return false;
+            return isLoaded_[index];
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @param scheduler the scheduler which creates loading threads.
+         * @param paths     system paths to programs.
+         * @return true if object has been constructed successfully.
+         */
+        bool RuntimeLoading::construct(api::Scheduler& scheduler, const char* const* paths)
+        {
+            for(int32 i=0; i<THREADS_NUMBER; i++)
+            {
+                threads_[i] = NULL;
+            }
+            if( not Self::isConstructed() ) return false;
+            if(paths == NULL || number_ <= 0 || number_ > PATHS_NUMBER) return false;
+            for(int32 i=0; i<number_; i++)
+            {
+                if(paths[i] == NULL) return false;
+                paths_[i] = paths[i];
+                isLoaded_[i] = false;
+            }
+            int32 const threads = number_ < THREADS_NUMBER ? number_ : THREADS_NUMBER;
+            for(int32 i=0; i<threads; i++)
+            {
+                threads_[i] = scheduler.createThread(*this);
+                if(threads_[i] == NULL) break;
+            }
+            // The loading is started if one thread at least has been created
+            if(threads_[0] == NULL) return false;
+            for(int32 i=0; i<threads; i++)
+            {
+                if(threads_[i] == NULL) break;
+                threads_[i]->execute();
+            }
+            return true;
+        }
+    }
+}
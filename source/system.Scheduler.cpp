@@ -7,8 +7,10 @@
  */
 #include "system.Scheduler.hpp" 
 #include "system.SchedulerThread.hpp"
+#include "system.Future.hpp"
 #include "system.System.hpp"
-#include "system.Interrupt.hpp"
+#include "system.CriticalSection.hpp"
+#include "system.BootTrace.hpp"
 #include "os.h"
 
 namespace local
@@ -22,6 +24,7 @@ namespace local
             globalThread_  (),
             threads_       (NULL){
             setConstructed( construct() );
+            BootTrace::mark("Scheduler");
         }
       
         /** 
@@ -29,6 +32,12 @@ namespace local
          */
         Scheduler::~Scheduler()
         {
+            #ifdef SYSTEM_THREAD_STATISTICS
+            if(scheduler_ == this)
+            {
+                scheduler_ = NULL;
+            }
+            #endif
         }
         
         /**
@@ -57,6 +66,22 @@ namespace local
             return NULL;
         }
         
+        /**
+         * Submits a task for executing in a new thread.
+         *
+         * @param task an user task which main method will be invoked in a new thread at once.
+         * @return a new future of the task result.
+         */
+        Future* Scheduler::submit(api::Task& task)
+        {
+            if( not Self::isConstructed() ) return NULL;
+            Future* future = new Future(*this, task);
+            if(future == NULL) return NULL;
+            if(future->isConstructed()) return future;
+            delete future;
+            return NULL;
+        }
+        
         /**
          * Returns currently executing thread.
          *
@@ -68,7 +93,8 @@ namespace local
             {
                 System::terminate(ERROR_SYSCALL_CALLED);
             }
-            bool const is = Interrupt::disableAll();
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Scheduler::getCurrentThread");
+            CriticalSection const cs(site);
             api::Thread* thread = NULL;
             int64 id = static_cast<int64>( prc_id() );
             int32 length = threads_.getLength();
@@ -82,7 +108,6 @@ namespace local
             {
                 System::terminate(ERROR_RESOURCE_NOT_FOUND);
             }
-            Interrupt::enableAll(is);
             return *thread;
         }
         
@@ -96,6 +121,13 @@ namespace local
                 System::terminate(ERROR_SYSCALL_CALLED);
             }                
             prc_yield();
+            #ifdef SYSTEM_THREAD_STATISTICS
+            SchedulerThread* const thread = findCurrentThread();
+            if(thread != NULL)
+            {
+                thread->record(0, 0);
+            }
+            #endif
         }
         
         /** 
@@ -107,6 +139,65 @@ namespace local
         {
             return globalThread_;
         }    
+        
+        /**
+         * Returns the high-water mark of a thread stack usage.
+         *
+         * @param thread a thread created by this scheduler, which might be dead.
+         * @return the maximum number of used stack bytes, or -1 if the stack is not painted.
+         */
+        int32 Scheduler::getStackUsage(const api::Thread& thread) const
+        {
+            if( not Self::isConstructed() ) return -1;
+            return static_cast<const SchedulerThread&>(thread).getStackUsage();
+        }
+        
+        /**
+         * Copies statistics of the threads being executed.
+         *
+         * @param stats  a buffer for copying the statistics to.
+         * @param number the number of statistics the buffer can contain.
+         * @return the number of copied statistics.
+         */
+        int32 Scheduler::getStatistics(ThreadStatistics* const stats, int32 const number) const
+        {
+            #ifdef SYSTEM_THREAD_STATISTICS
+            if( not Self::isConstructed() ) return 0;
+            if(stats == NULL) return 0;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Scheduler::getStatistics");
+            CriticalSection const cs(site);
+            int32 const length = threads_.getLength();
+            int32 count = 0;
+            for(int32 i=0; i<length && count<number; i++)
+            {
+                SchedulerThread* const thread = threads_.get(i);
+                if(thread == NULL) break;
+                thread->getStatistics(stats[count++]);
+            }
+            return count;
+            #else
+            return 0;
+            #endif
+        }
+        
+        /**
+         * Records a blocking of the current thread.
+         *
+         * @param duration the blocking duration in nanoseconds.
+         */
+        void Scheduler::recordBlocking(int64 const duration)
+        {
+            #ifdef SYSTEM_THREAD_STATISTICS
+            // The scheduler is absent while the system is being constructed or destroyed
+            Scheduler* const scheduler = scheduler_;
+            if(scheduler == NULL) return;
+            SchedulerThread* const thread = scheduler->findCurrentThread();
+            if(thread != NULL)
+            {
+                thread->record(duration, 0);
+            }
+            #endif
+        }
     
         /** 
          * Constructor.
@@ -122,6 +213,12 @@ namespace local
             if( not isConstructed() ) return false;
             if( not globalThread_.isConstructed() ) return false;
             if( not threads_.isConstructed() ) return false;        
+            #ifdef SYSTEM_THREAD_STATISTICS
+            if(scheduler_ == NULL)
+            {
+                scheduler_ = this;
+            }
+            #endif
             return true;      
         }
         
@@ -133,10 +230,9 @@ namespace local
         bool Scheduler::addThread(SchedulerThread* thread)
         {
             if( not Self::isConstructed() ) return false;
-            bool const is = Interrupt::disableAll();
-            bool res = threads_.add(thread);
-            Interrupt::enableAll(is);
-            return res;
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Scheduler::addThread");
+            CriticalSection const cs(site);
+            return threads_.add(thread);
         }    
         
         /**
@@ -147,9 +243,36 @@ namespace local
         void Scheduler::removeThread(SchedulerThread* thread)
         {
             if( not Self::isConstructed() ) return;
-            bool const is = Interrupt::disableAll();
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Scheduler::removeThread");
+            CriticalSection const cs(site);
             threads_.removeElement(thread);
-            Interrupt::enableAll(is);
         }    
+        
+        #ifdef SYSTEM_THREAD_STATISTICS
+        /**
+         * Returns currently executing thread if it has been created by the scheduler.
+         *
+         * @return executing thread, or NULL if it is not found.
+         */
+        SchedulerThread* Scheduler::findCurrentThread() const
+        {
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Scheduler::findCurrentThread");
+            CriticalSection const cs(site);
+            int64 const id = static_cast<int64>( prc_id() );
+            int32 const length = threads_.getLength();
+            for(int32 i=0; i<length; i++)
+            {
+                SchedulerThread* const thread = threads_.get(i);
+                if(thread == NULL) break;
+                if(thread->getId() == id) return thread;
+            }
+            return NULL;
+        }
+        
+        /**
+         * The scheduler, which has been constructed.
+         */
+        Scheduler* Scheduler::scheduler_ = NULL;
+        #endif // SYSTEM_THREAD_STATISTICS
     }
 }
@@ -9,6 +9,8 @@
 #include "system.Mutex.hpp"
 #include "system.Semaphore.hpp"
 #include "system.Interrupt.hpp"
+#include "system.BootTrace.hpp"
+#include "system.Clock.hpp"
 #include "Program.hpp"
 #include "os.h"
 
@@ -33,9 +35,11 @@ namespace local
             heap_      (),
             gi_        (),
             runtime_   (),
-            scheduler_ (){
+            scheduler_ (),
+            service_   (scheduler_){
             bool const isConstructed = construct();
             setConstructed( isConstructed );
+            BootTrace::mark("System");
         }
 
         /**
@@ -62,8 +66,7 @@ namespace local
          */
         int64 System::getTime() const
         {
-            int64 const time = static_cast<int64>( time_core_n() );
-            return time;
+            return Clock::getTime();
         }
 
         /**
@@ -159,6 +162,31 @@ namespace local
             return proveResource(res);
         }
 
+        /**
+         * Creates a new deferred interrupt resource.
+         *
+         * @param handler - user class which implements an interrupt handler interface.
+         * @param source  - available interrupt source number.
+         * @return a new interrupt resource, or NULL if an error has been occurred.
+         */
+        api::Interrupt* System::createDeferredInterrupt(api::Task& handler, int32 source)
+        {
+            api::Interrupt* res = new Interrupt(handler, source, service_);
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new event group resource.
+         *
+         * @param flags - the initial value of the event flags.
+         * @return a new event group resource, or NULL if an error has been occurred.
+         */
+        EventGroup* System::createEventGroup(uint32 flags)
+        {
+            EventGroup* res = new EventGroup(flags);
+            return proveResource(res);
+        }
+
         /**
          * Terminates the operating system execution.
          *
@@ -183,6 +211,7 @@ namespace local
             }
             else
             {
+                BootTrace::mark("Program::start");
                 error = Program::start();
             }
             return error;
@@ -251,6 +280,18 @@ namespace local
                     res = false;
                     continue;
                 }
+                if( not service_.isConstructed() )
+                {
+                    res = false;
+                    continue;
+                }
+                // The service thread is created with the first deferred handler
+                BootTrace::mark("InterruptService");
+                if( not Clock::calibrate() )
+                {
+                    res = false;
+                    continue;
+                }
                 // The construction completed successfully
                 system_ = this;
                 break;
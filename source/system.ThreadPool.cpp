@@ -0,0 +1,198 @@
+/** 
+ * Pool of persistent worker threads for data-parallel loops.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.ThreadPool.hpp"
+#include "system.CriticalSection.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Constructor.
+         *
+         * @param scheduler the scheduler which creates worker threads.
+         * @param workers   the number of worker threads, which is less than THREADS_NUMBER.
+         */
+        ThreadPool::ThreadPool(api::Scheduler& scheduler, int32 const workers) : Parent(),
+            threadsNumber_ (workers + 1),
+            started_       (0),
+            executed_      (0),
+            job_           (NULL),
+            next_          (0),
+            end_           (0),
+            grain_         (1),
+            isStopping_    (false),
+            mutex_         (),
+            start_         (workers + 1),
+            complete_      (workers + 1){
+            bool const isConstructed = construct(scheduler);
+            setConstructed( isConstructed );
+        }
+        
+        /**
+         * Destructor.
+         */
+        ThreadPool::~ThreadPool()
+        {
+            if( start_.isConstructed() )
+            {
+                isStopping_ = true;
+                // The workers which have not been executed are the parties which do not wait
+                for(int32 i=executed_; i<threadsNumber_ - 1; i++)
+                {
+                    start_.arrive();
+                }
+                start_.await();
+            }
+            for(int32 i=0; i<THREADS_NUMBER - 1; i++)
+            {
+                if(thread_[i] == NULL) continue;
+                thread_[i]->join();
+                delete thread_[i];
+            }
+        }
+        
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */    
+        bool ThreadPool::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+        
+        /**
+         * Executes chunks of loops in a worker thread.
+         *
+         * @return zero, or error code if an error has been occurred.
+         */        
+        int32 ThreadPool::start()
+        {
+            int32 thread;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("ThreadPool::start");
+                CriticalSection const cs(site, CriticalSection::THREADS);
+                // The calling thread of loops has index zero
+                thread = ++started_;
+            }
+            while(true)
+            {
+                start_.await();
+                if(isStopping_) break;
+                executeChunks(thread);
+                complete_.await();
+            }
+            return 0;
+        }
+        
+        /**
+         * Returns size of stack.
+         *
+         * @return stack size in bytes.
+         */
+        int32 ThreadPool::getStackSize() const
+        {
+            return STACK_SIZE;
+        }
+        
+        /**
+         * Returns the number of threads executing a loop.
+         *
+         * @return the number of worker threads plus the calling thread.
+         */
+        int32 ThreadPool::getThreadsNumber() const
+        {
+            return threadsNumber_;
+        }
+        
+        /**
+         * Executes a job over an index range by all pool threads.
+         *
+         * @param job   the job.
+         * @param begin the first index of the range.
+         * @param end   the index next to the last index of the range.
+         * @param grain the minimal number of indexes in a chunk, or zero.
+         * @return true if the job has been executed.
+         */
+        bool ThreadPool::execute(Job& job, int32 const begin, int32 const end, int32 const grain)
+        {
+            if( not Self::isConstructed() ) return false;
+            if(grain < 0) return false;
+            if(begin >= end) return true;
+            if( not mutex_.lock() ) return false;
+            job_ = &job;
+            next_ = begin;
+            end_ = end;
+            grain_ = grain > 0 ? grain : 1;
+            // The barriers order the job fields for the workers, as they are set in critical sections
+            start_.await();
+            executeChunks(0);
+            complete_.await();
+            job_ = NULL;
+            mutex_.unlock();
+            return true;
+        }
+        
+        /**
+         * Executes chunks of the current job until the range is over.
+         *
+         * @param thread the pool thread index.
+         */
+        void ThreadPool::executeChunks(int32 const thread)
+        {
+            while(true)
+            {
+                int32 begin;
+                int32 end;
+                {
+                    static CriticalSection::Site site = CRITICAL_SECTION_SITE("ThreadPool::executeChunks");
+                    CriticalSection const cs(site, CriticalSection::THREADS);
+                    int32 const remain = end_ - next_;
+                    if(remain <= 0) break;
+                    int32 size = remain / (threadsNumber_ * CHUNKS_PER_THREAD);
+                    if(size < grain_) size = grain_;
+                    if(size > remain) size = remain;
+                    begin = next_;
+                    end = next_ + size;
+                    next_ = end;
+                }
+                job_->execute(begin, end, thread);
+            }
+        }
+        
+        /**
+         * Constructor.
+         *
+         * @param scheduler the scheduler which creates worker threads.
+         * @return true if object has been constructed successfully.
+         */
+        bool ThreadPool::construct(api::Scheduler& scheduler)
+        {
+            for(int32 i=0; i<THREADS_NUMBER - 1; i++)
+            {
+                thread_[i] = NULL;
+            }
+            if( not Self::isConstructed() ) return false;
+            if(threadsNumber_ < 1 || threadsNumber_ > THREADS_NUMBER) return false;
+            if( not mutex_.isConstructed() ) return false;
+            if( not start_.isConstructed() ) return false;
+            if( not complete_.isConstructed() ) return false;
+            for(int32 i=0; i<threadsNumber_ - 1; i++)
+            {
+                thread_[i] = scheduler.createThread(*this);
+                if(thread_[i] == NULL) return false;
+                // The OS process is created on the execution, and a worker is not dead until the pool is destroyed
+                thread_[i]->execute();
+                if(thread_[i]->getStatus() == api::Thread::DEAD) return false;
+                executed_++;
+            }
+            return true;
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/** 
+ * Binary trace of kernel events.
+ * 
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Trace.hpp"
+#include "system.CriticalSection.hpp"
+#include "system.Clock.hpp"
+#include "os.h"
+
+namespace local
+{ 
+    namespace system
+    {
+        /**
+         * Copies the recorded events.
+         *
+         * @param events a buffer for copying the events from the oldest to.
+         * @param number the number of events the buffer can contain.
+         * @return the number of copied events.
+         */
+        int32 Trace::read(Event* const events, int32 const number)
+        {
+            #ifdef SYSTEM_TRACE
+            if(events == NULL || number <= 0) return 0;
+            uint32 index;
+            uint32 end;
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Trace::read");
+                CriticalSection const cs(site);
+                uint32 const length = count_ < EVENTS_NUMBER ? count_ : EVENTS_NUMBER;
+                uint32 const size = length < static_cast<uint32>(number) ? length : static_cast<uint32>(number);
+                // Skip the oldest events which the buffer cannot contain, and the events recorded while copying
+                end = count_;
+                index = end - size;
+            }
+            uint32 copied = 0;
+            while(index != end)
+            {
+                static CriticalSection::Site site = CRITICAL_SECTION_SITE("Trace::read.copy");
+                CriticalSection const cs(site);
+                // The rest of the events has been overwritten or removed
+                if(count_ - end >= EVENTS_NUMBER) break;
+                if(count_ - index > EVENTS_NUMBER)
+                {
+                    index = count_ - EVENTS_NUMBER;
+                }
+                uint32 const batch = end - index < READ_BATCH ? end - index : READ_BATCH;
+                for(uint32 i=0; i<batch; i++)
+                {
+                    events[copied + i] = events_[(index + i) % EVENTS_NUMBER];
+                }
+                index += batch;
+                copied += batch;
+            }
+            return static_cast<int32>(copied);
+            #else
+            static_cast<void>(events);
+            static_cast<void>(number);
+            return 0;
+            #endif
+        }
+        
+        /**
+         * Returns the number of overwritten events.
+         *
+         * @return the number of lost events.
+         */
+        uint32 Trace::getLost()
+        {
+            #ifdef SYSTEM_TRACE
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Trace::getLost");
+            CriticalSection const cs(site);
+            return count_ > EVENTS_NUMBER ? count_ - EVENTS_NUMBER : 0;
+            #else
+            return 0;
+            #endif
+        }
+        
+        /**
+         * Removes all recorded events.
+         */
+        void Trace::reset()
+        {
+            #ifdef SYSTEM_TRACE
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Trace::reset");
+            CriticalSection const cs(site);
+            count_ = 0;
+            #endif
+        }
+        
+        #ifdef SYSTEM_TRACE
+
+        /**
+         * Writes an event to the trace buffer.
+         *
+         * @param type     an event type.
+         * @param argument an event argument.
+         */
+        void Trace::write(Type const type, uint32 const argument)
+        {
+            int16 const thread = static_cast<int16>( prc_id() );
+            static CriticalSection::Site site = CRITICAL_SECTION_SITE("Trace::write");
+            CriticalSection const cs(site);
+            Event& event = events_[count_ % EVENTS_NUMBER];
+            count_++;
+            event.time = Clock::getTime();
+            event.argument = argument;
+            event.type = static_cast<uint16>(type);
+            event.thread = thread;
+        }
+        
+        /**
+         * The trace buffer.
+         */
+        Trace::Event Trace::events_[Trace::EVENTS_NUMBER];
+        
+        /**
+         * The number of written events.
+         */
+        uint32 Trace::count_ = 0;
+        #endif // SYSTEM_TRACE
+    }
+}
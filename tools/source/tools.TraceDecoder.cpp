@@ -0,0 +1,222 @@
+/**
+ * Decoder of binary traces of kernel events.
+ *
+ * The host program reads the events copied by the Trace::read function 
+ * and written as is to a file, and prints them in the Chrome trace event 
+ * JSON format, which is opened by chrome://tracing or Perfetto UI.
+ * The trace must be decoded on a host of the same byte order.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Trace.hpp"
+#include <stdio.h>
+
+namespace local
+{
+    namespace tools
+    {
+        typedef system::Trace Trace;
+        
+        /**
+         * The maximum number of waits which have begun and have not ended.
+         */
+        const int32 WAITS_NUMBER = 1024;
+        
+        /**
+         * A wait which has begun.
+         */
+        struct Wait
+        {
+            uint32 argument;
+            uint16 type;
+            int16  thread;
+        };
+        
+        /**
+         * The waits which have begun.
+         */
+        Wait waits_[WAITS_NUMBER];
+        
+        /**
+         * The number of waits which have begun.
+         */
+        int32 waitsNumber_ = 0;
+        
+        /**
+         * Begins a wait of an event thread on an event resource.
+         *
+         * @param event the wait event.
+         */
+        void begin(const Trace::Event& event)
+        {
+            if(waitsNumber_ == WAITS_NUMBER) return;
+            Wait& wait = waits_[waitsNumber_++];
+            wait.argument = event.argument;
+            wait.type = event.type;
+            wait.thread = event.thread;
+        }
+        
+        /**
+         * Ends a wait of an event thread on an event resource.
+         *
+         * @param event the event ending the wait.
+         * @param type  the wait event type.
+         * @return true if the wait has begun, or false if the resource has been taken without waiting.
+         */
+        bool end(const Trace::Event& event, uint16 const type)
+        {
+            for(int32 i=waitsNumber_-1; i>=0; i--)
+            {
+                const Wait& wait = waits_[i];
+                if(wait.argument != event.argument || wait.type != type || wait.thread != event.thread) continue;
+                waits_[i] = waits_[--waitsNumber_];
+                return true;
+            }
+            return false;
+        }
+        
+        /**
+         * Prints an event.
+         *
+         * @param stream   a stream to print to.
+         * @param name     an event name.
+         * @param phase    a Chrome trace event phase.
+         * @param event    the event.
+         * @param time     the event time relative to the trace beginning in nanoseconds.
+         * @param isAsync  the event is an asynchronous event identified by its argument and thread.
+         * @param isFirst  the event is the first printed event.
+         */
+        void print(FILE* stream, const char* name, char phase, const Trace::Event& event, int64 time, bool isAsync, bool isFirst)
+        {
+            double const micros = static_cast<double>(time) / 1000.0;
+            ::fprintf(stream, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":0,\"tid\":%d", 
+                isFirst ? "" : ",", name, phase, micros, static_cast<int>(event.thread));
+            if(isAsync)
+            {
+                ::fprintf(stream, ",\"cat\":\"sync\",\"id\":\"%u.%d\"", 
+                    static_cast<unsigned>(event.argument), static_cast<int>(event.thread));
+            }
+            if(phase == 'i')
+            {
+                ::fprintf(stream, ",\"s\":\"t\"");
+            }
+            ::fprintf(stream, ",\"args\":{\"argument\":%u}}", static_cast<unsigned>(event.argument));
+        }
+        
+        /**
+         * Decodes a trace.
+         *
+         * @param input  a stream of the binary trace.
+         * @param output a stream of the JSON trace.
+         * @return the number of decoded events.
+         */
+        int32 decode(FILE* input, FILE* output)
+        {
+            Trace::Event event;
+            int64 beginning = 0;
+            int32 count = 0;
+            // An event which only ends a wait which has not begun is not printed
+            bool isFirst = true;
+            ::fprintf(output, "{\"traceEvents\":[");
+            while( ::fread(&event, sizeof(event), 1, input) == 1 )
+            {
+                if(count == 0)
+                {
+                    beginning = event.time;
+                }
+                int64 const time = event.time - beginning;
+                bool isPrinted = true;
+                switch(event.type)
+                {
+                    case Trace::THREAD_CREATE:
+                        print(output, "Thread.create", 'i', event, time, false, isFirst);
+                        break;
+                    case Trace::THREAD_EXIT:
+                        print(output, "Thread.exit", 'i', event, time, false, isFirst);
+                        break;
+                    case Trace::MUTEX_WAIT:
+                        print(output, "Mutex.wait", 'b', event, time, true, isFirst);
+                        begin(event);
+                        break;
+                    case Trace::MUTEX_LOCK:
+                        if( end(event, Trace::MUTEX_WAIT) )
+                        {
+                            print(output, "Mutex.wait", 'e', event, time, true, isFirst);
+                            isFirst = false;
+                        }
+                        print(output, "Mutex.lock", 'b', event, time, true, isFirst);
+                        break;
+                    case Trace::MUTEX_UNLOCK:
+                        print(output, "Mutex.lock", 'e', event, time, true, isFirst);
+                        break;
+                    case Trace::SEMAPHORE_WAIT:
+                        print(output, "Semaphore.wait", 'b', event, time, true, isFirst);
+                        begin(event);
+                        break;
+                    case Trace::SEMAPHORE_ACQUIRE:
+                        isPrinted = end(event, Trace::SEMAPHORE_WAIT);
+                        if(isPrinted)
+                        {
+                            print(output, "Semaphore.wait", 'e', event, time, true, isFirst);
+                        }
+                        break;
+                    case Trace::SEMAPHORE_RELEASE:
+                        print(output, "Semaphore.release", 'i', event, time, false, isFirst);
+                        break;
+                    case Trace::INTERRUPT_ENTER:
+                        print(output, "Interrupt", 'B', event, time, false, isFirst);
+                        break;
+                    case Trace::INTERRUPT_EXIT:
+                        print(output, "Interrupt", 'E', event, time, false, isFirst);
+                        break;
+                    case Trace::ALLOCATE:
+                        print(output, "Allocator.allocate", 'i', event, time, false, isFirst);
+                        break;
+                    case Trace::FREE:
+                        print(output, "Allocator.free", 'i', event, time, false, isFirst);
+                        break;
+                    default:
+                        print(output, "Unknown", 'i', event, time, false, isFirst);
+                        break;
+                }
+                if(isPrinted)
+                {
+                    isFirst = false;
+                }
+                count++;
+            }
+            ::fprintf(output, "\n],\"displayTimeUnit\":\"ns\"}\n");
+            return count;
+        }
+    }
+}
+
+/**
+ * Decodes a trace file.
+ *
+ * @param argc the number of arguments.
+ * @param argv the binary trace file path, or the standard input if no path is given.
+ * @return zero, or one if an error has been occurred.
+ */
+int main(int argc, char** argv)
+{
+    FILE* input = stdin;
+    if(argc > 1)
+    {
+        input = ::fopen(argv[1], "rb");
+        if(input == NULL)
+        {
+            ::fprintf(stderr, "Cannot open %s\n", argv[1]);
+            return 1;
+        }
+    }
+    int const count = static_cast<int>( ::local::tools::decode(input, stdout) );
+    ::fprintf(stderr, "%d events decoded\n", count);
+    if(input != stdin)
+    {
+        ::fclose(input);
+    }
+    return 0;
+}